@@ -0,0 +1,221 @@
+#include <benchmark/benchmark.h>
+
+#include <Components/Ecosystem/ApplicationSettings.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Common;
+
+namespace {
+
+std::string benchSectionName(int64_t sectionSize) {
+    return "bench_lookup_" + std::to_string(sectionSize);
+}
+
+void fillSection(const std::string& section, int64_t sectionSize) {
+    auto& settings = ApplicationSettings::getInstance();
+    if (settings.hasSetting(section, "key_0")) {
+        return;
+    }
+    for (int64_t i = 0; i < sectionSize; ++i) {
+        settings.addSetting(section, "key_" + std::to_string(i))->setValue(i);
+    }
+}
+
+std::filesystem::path generateIni(int64_t keyCount, int64_t keysPerSection = 100) {
+    auto iniPath = std::filesystem::temp_directory_path() /
+                   ("common_bench_" + std::to_string(keyCount) + ".ini");
+    std::ofstream out(iniPath);
+    for (int64_t i = 0; i < keyCount; ++i) {
+        if (i % keysPerSection == 0) {
+            out << "[section_" << i / keysPerSection << "]\n";
+        }
+        switch (i % 3) {
+        case 0: out << "int_" << i << "=" << i << "\n"; break;
+        case 1: out << "dbl_" << i << "=" << i << ".5\n"; break;
+        case 2: out << "str_" << i << "=value_" << i << "\n"; break;
+        }
+    }
+    return iniPath;
+}
+
+} // namespace
+
+static void BM_SettingLookupBySectionSize(benchmark::State& state) {
+    auto section = benchSectionName(state.range(0));
+    fillSection(section, state.range(0));
+
+    auto& settings = ApplicationSettings::getInstance();
+    auto lastKey = "key_" + std::to_string(state.range(0) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.getSetting(section, lastKey));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_SettingLookupBySectionSize)->RangeMultiplier(4)->Range(4, 4096)->Complexity();
+
+static void BM_LoadSettings(benchmark::State& state) {
+    auto iniPath = generateIni(state.range(0)).string();
+
+    auto& settings = ApplicationSettings::getInstance();
+    for (auto _ : state) {
+        settings.loadSettings(iniPath);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(iniPath);
+}
+BENCHMARK(BM_LoadSettings)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_SaveSettings(benchmark::State& state) {
+    auto iniPath = generateIni(state.range(0)).string();
+
+    auto& settings = ApplicationSettings::getInstance();
+    settings.loadSettings(iniPath);
+    for (auto _ : state) {
+        settings.saveSettings(iniPath);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(iniPath);
+}
+BENCHMARK(BM_SaveSettings)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ValueToString(benchmark::State& state) {
+    const AppSettingValue_t values[] = {
+        std::monostate{},
+        std::string("some string value"),
+        int64_t(1234567890),
+        3.14159265
+    };
+    const auto& value = values[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(valueToString(value));
+    }
+}
+BENCHMARK(BM_ValueToString)->DenseRange(0, 3)->ArgName("alternative");
+
+namespace {
+
+constexpr int64_t PREFIX_BENCH_KEYS {100000};
+constexpr int64_t PREFIX_BENCH_SECTIONS {1000};
+
+void fillPrefixBenchSettings() {
+    auto& settings = ApplicationSettings::getInstance();
+    if (settings.hasSetting("prefix_0", "key_0")) {
+        return;
+    }
+    for (int64_t i = 0; i < PREFIX_BENCH_KEYS; ++i) {
+        settings.addSetting("prefix_" + std::to_string(i % PREFIX_BENCH_SECTIONS), "key_" + std::to_string(i))->setValue(i);
+    }
+}
+
+} // namespace
+
+static void BM_PrefixScanIndexed(benchmark::State& state) {
+    fillPrefixBenchSettings();
+
+    auto& settings = ApplicationSettings::getInstance();
+    for (auto _ : state) {
+        int64_t found {0};
+        for (auto& entry : settings.findSettingsByPrefix("prefix_7.")) {
+            benchmark::DoNotOptimize(entry);
+            ++found;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_PrefixScanIndexed);
+
+static void BM_PrefixScanFullIteration(benchmark::State& state) {
+    fillPrefixBenchSettings();
+
+    auto& settings = ApplicationSettings::getInstance();
+    for (auto _ : state) {
+        int64_t found {0};
+        settings.forEachSetting([&found](const std::string& section, const std::shared_ptr<AppSetting>& pSett) {
+            if (section == "prefix_7") {
+                benchmark::DoNotOptimize(pSett);
+                ++found;
+            }
+        });
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_PrefixScanFullIteration)->Unit(benchmark::kMicrosecond);
+
+static void BM_GlobQueryIndexed(benchmark::State& state) {
+    fillPrefixBenchSettings();
+
+    auto& settings = ApplicationSettings::getInstance();
+    for (auto _ : state) {
+        int64_t found {0};
+        for (auto& entry : settings.findSettings("prefix_7*.key_*7")) {
+            benchmark::DoNotOptimize(entry);
+            ++found;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_GlobQueryIndexed)->Unit(benchmark::kMicrosecond);
+
+static void BM_SetValueNotifications(benchmark::State& state) {
+    auto& settings = ApplicationSettings::getInstance();
+    auto pSett = settings.addSetting("bench_notify", "value");
+
+    SettingsNotifier::SubscriptionId_t subscriptionId {0};
+    if (state.range(0)) {
+        subscriptionId = settings.getNotifier().subscribe("bench_notify.*", [](const std::vector<SettingChange>& changes) {
+            benchmark::DoNotOptimize(changes.data());
+        });
+    }
+
+    int64_t v {0};
+    for (auto _ : state) {
+        pSett->setValue(++v);
+    }
+
+    if (subscriptionId) {
+        settings.getNotifier().unsubscribe(subscriptionId);
+    }
+}
+BENCHMARK(BM_SetValueNotifications)->Arg(0)->Arg(1)->ArgName("subscribed");
+
+static void BM_GetSettingScopedOverride(benchmark::State& state) {
+    auto& settings = ApplicationSettings::getInstance();
+    settings.addSetting("bench_override", "value")->setValue(int64_t(1));
+
+    // 0 - no overrides, 1 - override of other setting active, 2 - override of read setting active
+    std::unique_ptr<ScopedSettingOverride> pOverride;
+    if (state.range(0) == 1) {
+        pOverride = std::make_unique<ScopedSettingOverride>("bench_override", "other", int64_t(2));
+    } else if (state.range(0) == 2) {
+        pOverride = std::make_unique<ScopedSettingOverride>("bench_override", "value", int64_t(2));
+    }
+
+    const std::string section {"bench_override"};
+    const std::string settingName {"value"};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.getSetting(section, settingName));
+    }
+}
+BENCHMARK(BM_GetSettingScopedOverride)->DenseRange(0, 2)->ArgName("override");
+
+static void BM_ArraySettingRead(benchmark::State& state) {
+    std::string text;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        text += (i == 0 ? "" : ",") + std::to_string(i);
+    }
+    AppIntArraySetting sett;
+    sett.setRawValue(text);
+
+    // Elements are parsed once in setRawValue, reading is summing contiguous memory
+    for (auto _ : state) {
+        int64_t sum {0};
+        for (auto v : sett.getValues()) {
+            sum += v;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArraySettingRead)->Arg(16)->Arg(1024);
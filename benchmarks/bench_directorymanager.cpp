@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <Components/Ecosystem/AtomicFileWriter.h>
+#include <Components/Ecosystem/DirectoryManager.h>
+#include <Components/Ecosystem/MappedFileRegistry.h>
+
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Common;
+
+static void BM_GetDirectoryStatic(benchmark::State& state) {
+    auto& dirManager = DirectoryManager::getInstance();
+    if (dirManager.getRootPath().empty()) {
+        dirManager.setRootPath(std::filesystem::temp_directory_path() / "common_bench_root");
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DirectoryManager::getDirectoryStatic(DirectoryType::Data));
+    }
+}
+BENCHMARK(BM_GetDirectoryStatic);
+
+static void BM_OpenDataFile(benchmark::State& state) {
+    auto& dirManager = DirectoryManager::getInstance();
+    if (dirManager.getRootPath().empty()) {
+        dirManager.setRootPath(std::filesystem::temp_directory_path() / "common_bench_root");
+    }
+    ::close(dirManager.openFile(DirectoryType::Data, "bench.bin", O_WRONLY | O_CREAT));
+
+    // 0 - full path is built and resolved for each open, 1 - open relative to cached directory descriptor
+    auto isRelative = (state.range(0) == 1);
+    for (auto _ : state) {
+        auto fd = (isRelative ? dirManager.openFile(DirectoryType::Data, "bench.bin", O_RDONLY) :
+                                ::open((DirectoryManager::getDirectoryStatic(DirectoryType::Data) / "bench.bin").c_str(), O_RDONLY));
+        ::close(fd);
+    }
+}
+BENCHMARK(BM_OpenDataFile)->Arg(0)->Arg(1)->ArgName("relative");
+
+static void BM_AtomicWriteFile(benchmark::State& state) {
+    auto& dirManager = DirectoryManager::getInstance();
+    if (dirManager.getRootPath().empty()) {
+        dirManager.setRootPath(std::filesystem::temp_directory_path() / "common_bench_root");
+    }
+
+    const std::string data(4096, 'x');
+    auto durability = static_cast<Durability>(state.range(0));
+    auto fileName = "atomic_" + std::to_string(state.thread_index());
+    for (auto _ : state) {
+        AtomicFileWriter::getInstance().writeFile(DirectoryType::Data, fileName, data, durability);
+    }
+}
+BENCHMARK(BM_AtomicWriteFile)->DenseRange(0, 2)->ArgName("durability")->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ReadDataFile(benchmark::State& state) {
+    auto& dirManager = DirectoryManager::getInstance();
+    if (dirManager.getRootPath().empty()) {
+        dirManager.setRootPath(std::filesystem::temp_directory_path() / "common_bench_root");
+    }
+    AtomicFileWriter::getInstance().writeFile(DirectoryType::Data, "mapped.bin", std::string(4 << 20, 'x'));
+
+    // 0 - file is read by stream each time, 1 - shared mapping is taken from registry
+    auto isMapped = (state.range(0) == 1);
+    auto& registry = MappedFileRegistry::getInstance();
+    auto pHolder = registry.map(DirectoryType::Data, "mapped.bin"); // Other user of file keeps mapping alive
+    for (auto _ : state) {
+        uint64_t sum {0};
+        if (isMapped) {
+            auto pMapping = registry.map(DirectoryType::Data, "mapped.bin");
+            for (auto byte : pMapping->getData()) {
+                sum += static_cast<uint8_t>(byte);
+            }
+        } else {
+            std::ifstream input(DirectoryManager::getDirectoryStatic(DirectoryType::Data) / "mapped.bin", std::ios::binary);
+            std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+            for (auto byte : data) {
+                sum += static_cast<uint8_t>(byte);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * (4 << 20));
+}
+BENCHMARK(BM_ReadDataFile)->Arg(0)->Arg(1)->ArgName("mapped");
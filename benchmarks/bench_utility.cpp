@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <Components/Ecosystem/Executor.h>
+#include <Components/Ecosystem/Symbolizer.h>
+#include <Components/Ecosystem/TerminalScreen.h>
+#include <Components/Ecosystem/Tracing.h>
+#include <Components/Ecosystem/Utility.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Common;
+
+static void BM_CreateRandomNumber(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(createRandomNumber(0, 1000000));
+    }
+}
+BENCHMARK(BM_CreateRandomNumber);
+
+static void BM_CreateRandomString(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(createRandomString(state.range(0)));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CreateRandomString)->RangeMultiplier(4)->Range(8, 512);
+
+static void BM_GetCurrentTimestampFormatted(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(getCurrentTimestampFormatted());
+    }
+}
+BENCHMARK(BM_GetCurrentTimestampFormatted);
+
+static void BM_GenerateUniqueId(benchmark::State& state) {
+    char buffer[UniqueId::BASE32_LENGTH];
+    for (auto _ : state) {
+        generateUniqueId().toBase32(buffer);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateUniqueId)->ThreadRange(1, 8);
+
+static void BM_GenerateUniqueIdsBulk(benchmark::State& state) {
+    std::vector<UniqueId> ids(state.range(0));
+    for (auto _ : state) {
+        generateUniqueIds(ids.data(), ids.size());
+        benchmark::DoNotOptimize(ids.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateUniqueIdsBulk)->Arg(1024);
+
+static void BM_RandomStreamFill(benchmark::State& state) {
+    // 0 - uniform int, 1 - uniform real, 2 - normal, 3 - std::normal_distribution over std::mt19937_64
+    std::vector<double> reals(4096);
+    std::vector<int32_t> ints(reals.size());
+    auto stream = RandomStream(1).split(state.thread_index());
+    std::mt19937_64 mt(state.thread_index());
+    std::normal_distribution<double> normal;
+    for (auto _ : state) {
+        switch (state.range(0)) {
+        case 0:     stream.fillUniformInt(ints.data(), ints.size(), 0, 1000000); break;
+        case 1:     stream.fillUniformReal(reals.data(), reals.size()); break;
+        case 2:     stream.fillNormal(reals.data(), reals.size()); break;
+        default:
+            for (auto& value : reals) {
+                value = normal(mt);
+            }
+        }
+        benchmark::DoNotOptimize(reals.data());
+        benchmark::DoNotOptimize(ints.data());
+    }
+    state.SetItemsProcessed(state.iterations() * reals.size());
+}
+BENCHMARK(BM_RandomStreamFill)->DenseRange(0, 3)->ArgName("distribution")->ThreadRange(1, 8);
+
+static void BM_SymbolizeStacktraceCached(benchmark::State& state) {
+    auto& symbolizer = Symbolizer::getInstance();
+    symbolizer.symbolize(CapturedStacktrace::capture());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(symbolizer.symbolize(CapturedStacktrace::capture()));
+    }
+}
+BENCHMARK(BM_SymbolizeStacktraceCached);
+
+static void BM_TraceSpan(benchmark::State& state) {
+    auto& tracer = Tracer::getInstance();
+    tracer.clear();
+    tracer.setEnabled(state.range(0) != 0);
+    uint64_t spansCount {0};
+    for (auto _ : state) {
+        COMMON_TRACE_SCOPE("bench_span");
+        benchmark::ClobberMemory();
+        if (++spansCount % tracer.getThreadCapacity() == 0) {
+            tracer.clear(); // Spans are recorded, not dropped
+        }
+    }
+    tracer.setEnabled(false);
+    tracer.clear();
+}
+BENCHMARK(BM_TraceSpan)->Arg(0);
+BENCHMARK(BM_TraceSpan)->Arg(1);
+
+static void BM_TerminalScreenFrame(benchmark::State& state) {
+    int nullFd = ::open("/dev/null", O_WRONLY);
+    TerminalScreen screen(120, 40, nullFd);
+
+    // Dashboard where one counter per row changes every frame
+    uint64_t frameIndex {0};
+    std::size_t bytesWritten {0};
+    for (auto _ : state) {
+        ++frameIndex;
+        for (unsigned y = 0; y < screen.getHeight(); ++y) {
+            screen.putText(0, y, "worker " + std::to_string(y) + ": processed " + std::to_string(frameIndex * (y + 1)));
+        }
+        screen.present();
+        bytesWritten += screen.getLastFrameSize();
+    }
+    state.counters["bytes_per_frame"] = benchmark::Counter(double(bytesWritten) / state.iterations());
+    ::close(nullFd);
+}
+BENCHMARK(BM_TerminalScreenFrame);
+
+static int64_t recursiveFib(Executor& executor, int n) {
+    if (n < 12) {
+        return (n < 2 ? n : recursiveFib(executor, n - 1) + recursiveFib(executor, n - 2));
+    }
+    auto left = executor.submit([&executor, n]() { return recursiveFib(executor, n - 1); });
+    auto right = recursiveFib(executor, n - 2);
+    return left.get() + right;
+}
+
+static void BM_ExecutorFineGrainedTasks(benchmark::State& state) {
+    Executor executor({static_cast<unsigned>(state.range(0)), {}});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(executor.submit([&executor]() { return recursiveFib(executor, 27); }).get());
+    }
+    state.counters["threads"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ExecutorFineGrainedTasks)->RangeMultiplier(2)->Range(1, std::max(std::thread::hardware_concurrency(), 1u))
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
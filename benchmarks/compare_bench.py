@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON reports produced by Common_bench.
+
+Usage:
+    compare_bench.py BASELINE.json CURRENT.json [--threshold 0.10] [--metric cpu_time]
+
+Exits with code 1 if any benchmark present in both reports got slower
+than the allowed threshold (relative, 0.10 == 10%).
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_report(path, metric):
+    with open(path, "r", encoding="utf-8") as f:
+        report = json.load(f)
+
+    results = {}
+    for bench in report.get("benchmarks", []):
+        # Skip aggregates other than mean when repetitions are used
+        if bench.get("run_type") == "aggregate" and bench.get("aggregate_name") != "mean":
+            continue
+        if metric not in bench:
+            continue
+        name = bench.get("run_name", bench["name"])
+        scale = TIME_UNIT_NS.get(bench.get("time_unit", "ns"), 1.0)
+        results[name] = bench[metric] * scale
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed relative slowdown before failing (default: 0.10)")
+    parser.add_argument("--metric", default="cpu_time", choices=("cpu_time", "real_time"))
+    args = parser.parse_args()
+
+    baseline = load_report(args.baseline, args.metric)
+    current = load_report(args.current, args.metric)
+
+    regressions = []
+    width = max((len(n) for n in current), default=10)
+    print(f"{'Benchmark':<{width}}  {'Baseline ns':>14}  {'Current ns':>14}  {'Change':>8}")
+    for name, curTime in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>14}  {curTime:>14.1f}  {'new':>8}")
+            continue
+        baseTime = baseline[name]
+        change = (curTime - baseTime) / baseTime if baseTime > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            regressions.append(name)
+            mark = "  <-- REGRESSION"
+        print(f"{name:<{width}}  {baseTime:>14.1f}  {curTime:>14.1f}  {change:>+7.1%}{mark}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<{width}}  {baseline[name]:>14.1f}  {'-':>14}  {'removed':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than {args.threshold:.0%}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
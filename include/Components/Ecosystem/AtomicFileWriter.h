@@ -0,0 +1 @@
+#include "../../../src/atomicfilewriter.hpp"
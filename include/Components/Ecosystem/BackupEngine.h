@@ -0,0 +1 @@
+#include "../../../src/backupengine.hpp"
@@ -0,0 +1 @@
+#include "../../../src/directorymonitor.hpp"
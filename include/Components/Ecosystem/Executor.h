@@ -0,0 +1 @@
+#include "../../../src/executor.hpp"
@@ -0,0 +1 @@
+#include "../../../src/mappedfileregistry.hpp"
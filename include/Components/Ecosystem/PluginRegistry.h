@@ -0,0 +1 @@
+#include "../../../src/pluginregistry.hpp"
@@ -0,0 +1 @@
+#include "../../../src/settingsitemmodel.hpp"
@@ -0,0 +1 @@
+#include "../../../src/shutdowncoordinator.hpp"
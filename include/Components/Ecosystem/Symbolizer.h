@@ -0,0 +1 @@
+#include "../../../src/symbolizer.hpp"
@@ -0,0 +1 @@
+#include "../../../src/terminalscreen.hpp"
@@ -0,0 +1 @@
+#include "../../../src/tracing.hpp"
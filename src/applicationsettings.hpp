@@ -4,7 +4,14 @@
 // Setting types
 #include "appsettings/appsetting.hpp"
 #include "appsettings/numericsetting.hpp"
+#include "appsettings/arraysetting.hpp"
 
 // Settings object
+#include "appsettings/settingslayer.hpp"
+#include "appsettings/settingsindex.hpp"
+#include "appsettings/settingsnotifier.hpp"
+#include "appsettings/settingstransaction.hpp"
+#include "appsettings/scopedsettingoverride.hpp"
 #include "appsettings/applicationsettings.hpp"
+#include "appsettings/sharedsettingssegment.hpp"
 
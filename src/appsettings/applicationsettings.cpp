@@ -1,10 +1,14 @@
 #include "applicationsettings.hpp"
 
+#include "../atomicfilewriter.hpp"
+#include "../tracing.hpp"
+
 #include <Components/Logger/Logger.h>
 #include <Components/Filework/ConfigParsing/IniParser.h>
 
 #include <filesystem>
-#include <fstream>
+
+extern char **environ;
 
 namespace Common {
 
@@ -21,27 +25,161 @@ std::shared_ptr<AppSetting> ApplicationSettings::addSetting(const std::string &s
 {
     auto pSett = std::make_shared<AppSetting>();
     pSett->setName(settingName);
-    m_settingSections[section].insert(pSett);
+    addSetting(section, pSett);
     return pSett;
 }
 
 void ApplicationSettings::addSetting(const std::string &section, const std::shared_ptr<AppSetting>& pSetting)
 {
-    m_settingSections[section].insert(pSetting);
+    std::string settingName(pSetting->getName());
+    m_settingSections[section][settingName] = pSetting;
+    if (isInLayers(section, settingName)) {
+        rebuildOverlayKey(section, settingName); // Layer values are checked by rules of new base setting
+        return;
+    }
+    setEffectiveSetting(section, settingName, pSetting, pSetting->isSet());
 }
 
 std::shared_ptr<AppSetting> ApplicationSettings::getSetting(const std::string &section, const std::string &settingName) const
 {
-    if (!m_settingSections.count(section)) {
+    if (ScopedSettingOverride::hasActiveOverrides()) {
+        if (auto pOverride = ScopedSettingOverride::findOverride(section, settingName); pOverride) {
+            return pOverride;
+        }
+    }
+    return m_settingsIndex.find(section, settingName);
+}
+
+bool ApplicationSettings::removeSetting(const std::string &section, const std::string &settingName)
+{
+    auto sectionIt = m_settingSections.find(section);
+    if (sectionIt == m_settingSections.end()) {
+        return false;
+    }
+    auto settIt = sectionIt->second.find(settingName);
+    if (settIt == sectionIt->second.end()) {
+        return false;
+    }
+    sectionIt->second.erase(settIt);
+    if (sectionIt->second.empty()) {
+        m_settingSections.erase(sectionIt);
+    }
+    rebuildOverlayKey(section, settingName); // Layer value, rejected by removed setting, may become effective
+    return true;
+}
+
+SettingsTransaction ApplicationSettings::beginTransaction()
+{
+    return SettingsTransaction(*this);
+}
+
+std::shared_lock<std::shared_mutex> ApplicationSettings::lockShared() const
+{
+    return std::shared_lock(m_transactionMx);
+}
+
+uint64_t ApplicationSettings::getVersion() const
+{
+    std::shared_lock lock(m_transactionMx);
+    return m_currentVersion;
+}
+
+void ApplicationSettings::setHistoryDepth(std::size_t depth)
+{
+    std::unique_lock lock(m_transactionMx);
+    m_historyDepth = depth;
+    while (m_versions.size() > m_historyDepth) {
+        m_versions.pop_front();
+    }
+}
+
+static std::optional<AppSettingValue_t> resolveValue(const std::optional<AppSettingValue_t>& value, bool isRaw) {
+    if (value && isRaw) {
+        return valueFromString(std::get<std::string>(*value));
+    }
+    return value;
+}
+
+std::vector<SettingVersionChange> ApplicationSettings::diffVersions(uint64_t fromVersion, uint64_t toVersion) const
+{
+    std::shared_lock lock(m_transactionMx);
+
+    auto isReversed = (fromVersion > toVersion);
+    if (isReversed) {
+        std::swap(fromVersion, toVersion);
+    }
+    if (!isVersionInHistory(fromVersion, false) || !isVersionInHistory(toVersion, false)) {
         return {};
     }
 
-    for (const auto& pSetting : m_settingSections.at(section)) {
-        if (pSetting->getName() == settingName) {
-            return pSetting;
+    // Compose deltas: first old value and last new value of every key
+    std::map<std::pair<std::string, std::string>, SettingVersionChange> composed;
+    for (auto& version : m_versions) {
+        if (version.id <= fromVersion || version.id > toVersion) {
+            continue;
+        }
+        for (auto& recorded : version.changes) {
+            auto& change = recorded.change;
+            auto [composedIt, isInserted] = composed.try_emplace({change.section, change.name}, SettingVersionChange {change.section, change.name, std::nullopt, std::nullopt});
+            if (isInserted) {
+                composedIt->second.oldValue = resolveValue(change.oldValue, recorded.isOldRaw);
+            }
+            composedIt->second.newValue = resolveValue(change.newValue, recorded.isNewRaw);
         }
     }
-    return {};
+
+    std::vector<SettingVersionChange> res;
+    res.reserve(composed.size());
+    for (auto& [key, change] : composed) {
+        if (change.oldValue == change.newValue) {
+            continue;
+        }
+        if (isReversed) {
+            std::swap(change.oldValue, change.newValue);
+        }
+        res.push_back(std::move(change));
+    }
+    return res;
+}
+
+bool ApplicationSettings::rollbackTo(uint64_t version)
+{
+    if (!isVersionInHistory(version)) {
+        COMPLOG_ERROR("Settings version is out of history:", version);
+        return false;
+    }
+
+    auto transaction = beginTransaction();
+    for (auto& change : diffVersions(getVersion(), version)) {
+        if (change.newValue) {
+            transaction.setValue(change.section, change.name, *change.newValue);
+        } else {
+            transaction.removeSetting(change.section, change.name);
+        }
+    }
+    return transaction.commit();
+}
+
+SettingsNotifier &ApplicationSettings::getNotifier()
+{
+    return m_notifier;
+}
+
+SettingsIndex::Range ApplicationSettings::findSettings(std::string_view globPattern) const
+{
+    return m_settingsIndex.findMatching(globPattern);
+}
+
+SettingsIndex::Range ApplicationSettings::findSettingsByPrefix(std::string_view prefix) const
+{
+    return m_settingsIndex.findPrefix(prefix);
+}
+
+void ApplicationSettings::forEachSetting(const std::function<void (const std::string &, const std::shared_ptr<AppSetting> &)> &callback) const
+{
+    for (auto& [fullKey, entry] : m_settingsIndex.all()) {
+        callback(entry.section, entry.pSetting);
+    }
 }
 
 ApplicationSettings& ApplicationSettings::getInstance() {
@@ -51,6 +189,7 @@ ApplicationSettings& ApplicationSettings::getInstance() {
 
 bool ApplicationSettings::parseArguments(int argc, char *argv[])
 {
+    COMMON_TRACE_SCOPE("ApplicationSettings::parseArguments");
     std::string curargName;
 
     for (int i = 0; i < argc; ++i) {
@@ -61,26 +200,14 @@ bool ApplicationSettings::parseArguments(int argc, char *argv[])
             continue;
         }
         auto& sett = m_arguments[curargName];
+        if (!sett) {
+            sett = std::make_shared<AppSetting>();
+        }
         if (sett->isSet()) {
             continue;
         }
         sett->setName(curargName);
-        sett->setValue(token);
-    }
-
-    for (auto& [argName, argValue] : m_arguments) {
-        if (argValue) {
-            continue;
-        }
-        try {
-            argValue->setValue(std::stoll(argValue->getValueString()));
-        } catch (std::invalid_argument& ex) {
-            try {
-                argValue->setValue(std::stod(argValue->getValueString()));
-            } catch (std::invalid_argument&) {
-                // Do nothing
-            }
-        }
+        sett->setRawValue(token);
     }
 
     return true;
@@ -99,13 +226,13 @@ void ApplicationSettings::loadSettings(const std::string& configPath) {
     if (configPath.empty()) {
         return loadSettings(m_currentConfigsPath);
     }
+    COMMON_TRACE_SCOPE("ApplicationSettings::loadSettings");
 
     m_currentConfigsPath = configPath;
     COMPLOG_INFO("Loading settings from file:", configPath);
 
     if (!std::filesystem::exists(configPath)) {
-        std::ofstream creator(configPath);
-        creator.close();
+        AtomicFileWriter::getInstance().writeFile(configPath, {}, Durability::Data);
         COMPLOG_INFO("Settings file not exist, created empty one");
     }
 
@@ -115,32 +242,111 @@ void ApplicationSettings::loadSettings(const std::string& configPath) {
         return;
     }
 
+    SettingsNotifier::Batch notifyBatch(m_notifier);
+    std::unique_lock lock(m_transactionMx);
+    auto notifyBatchSize = m_notifier.getBatchSize();
+
+    // Values are kept before load, because registered base settings are reused and change in place
+    struct PrevValue
+    {
+        std::optional<std::string>  rawValue;
+        AppSettingValue_t           value;      // If there is no source text
+    };
+    std::map<std::pair<std::string, std::string>, PrevValue> prevValues;
+    for (auto& [fullKey, entry] : m_settingsIndex.all()) {
+        PrevValue prevValue;
+        if (auto rawValue = entry.pSetting->getRawValue(); rawValue) {
+            prevValue.rawValue = std::string(*rawValue);
+        } else {
+            prevValue.value = entry.pSetting->getValueVariant();
+        }
+        prevValues.emplace(std::make_pair(entry.section, std::string(entry.pSetting->getName())), std::move(prevValue));
+        entry.pSetting->m_pNotifier = nullptr;
+    }
+    auto prevSections = std::move(m_settingSections);
     m_settingSections.clear();
+    m_settingsIndex.clear();
+    for (auto& [section, setts] : m_overlayIndex) {
+        for (auto& [settingName, pSett] : setts) {
+            setEffectiveSetting(section, settingName, pSett, false);
+        }
+    }
     for (auto& groupName : iniParser.getSections()) {
+        auto prevSectionIt = prevSections.find(groupName);
         for (auto& [valueName, value] : iniParser.getSection(groupName)) {
-            if (auto pSett = addSetting(groupName, valueName); pSett) {
-                auto dotCount = std::count(value.begin(), value.end(), '.');
-                if (dotCount == 0) {
-                    try {
-                        pSett->setValue(std::stoll(value.data()));
-                    } catch ([[maybe_unused]] std::invalid_argument& ex) { // Ignore exception, it's normal
-                        pSett->setValue(value.data());
-                    }
-                } else if (dotCount == 1) {
-                    try {
-                        pSett->setValue(std::stod(value.data()));
-                    } catch ([[maybe_unused]] std::invalid_argument& ex) { // Ignore exception, it's normal
-                        pSett->setValue(value.data());
-                    }
-                } else {
-                    pSett->setValue(value.data());
+            std::shared_ptr<AppSetting> pSett;
+            if (prevSectionIt != prevSections.end()) {
+                if (auto prevSettIt = prevSectionIt->second.find(valueName); prevSettIt != prevSectionIt->second.end()) {
+                    pSett = prevSettIt->second;
                 }
+            }
+            if (!pSett) {
+                addSetting(groupName, valueName)->setRawValue(value.data());
                 continue;
             }
-            addSetting(groupName, valueName);
-            getSetting(groupName, valueName)->setValue(value.data());
+
+            // Registered setting (typed one, for example) parses and checks text of config itself
+            if (!pSett->setRawValue(value.data())) {
+                COMPLOG_ERROR("Settings value is rejected, previous value is kept:", groupName + "." + valueName);
+            }
+            addSetting(groupName, pSett);
         }
     }
+    for (auto& layer : m_layers) {
+        rebuildOverlay(layer.getSettings()); // Layer values are checked by rules of loaded base settings
+    }
+
+    // Values are not converted here if both old and new ones are source text
+    auto recordPrevValue = [](const PrevValue& prevValue, std::optional<AppSettingValue_t>& value, bool& isRaw) {
+        isRaw = prevValue.rawValue.has_value();
+        value = (isRaw ? AppSettingValue_t(*prevValue.rawValue) : prevValue.value);
+    };
+    auto recordValue = [](const std::shared_ptr<AppSetting>& pSett, std::optional<AppSettingValue_t>& value, bool& isRaw) {
+        if (auto rawValue = pSett->getRawValue(); rawValue) {
+            value = std::string(*rawValue);
+            isRaw = true;
+            return;
+        }
+        value = pSett->getValueVariant();
+    };
+    std::vector<SettingsVersion::RecordedChange> loadChanges;
+    for (auto& [fullKey, entry] : m_settingsIndex.all()) {
+        auto key = std::make_pair(entry.section, std::string(entry.pSetting->getName()));
+        auto prevIt = prevValues.find(key);
+
+        SettingsVersion::RecordedChange change {{key.first, key.second, std::nullopt, std::nullopt}};
+        if (prevIt != prevValues.end()) {
+            auto& prevValue = prevIt->second;
+            auto newRaw = entry.pSetting->getRawValue();
+            auto isEqual = (prevValue.rawValue && newRaw ? (*prevValue.rawValue == *newRaw) :
+                                                           ((prevValue.rawValue ? valueFromString(*prevValue.rawValue) : prevValue.value) ==
+                                                            entry.pSetting->getValueVariant()));
+            if (!isEqual) {
+                recordPrevValue(prevValue, change.change.oldValue, change.isOldRaw);
+            }
+            prevValues.erase(prevIt);
+            if (isEqual) {
+                continue;
+            }
+        }
+        recordValue(entry.pSetting, change.change.newValue, change.isNewRaw);
+        loadChanges.push_back(std::move(change));
+    }
+    for (auto& [key, prevValue] : prevValues) {
+        SettingsVersion::RecordedChange change {{key.first, key.second, std::nullopt, std::nullopt}};
+        recordPrevValue(prevValue, change.change.oldValue, change.isOldRaw);
+        loadChanges.push_back(std::move(change));
+    }
+
+    // Settings were replaced one by one, subscribers get only difference, recorded to history
+    m_notifier.dropBatchChanges(notifyBatchSize);
+    if (m_notifier.hasSubscribers()) {
+        for (auto& recorded : loadChanges) {
+            auto pSett = m_settingsIndex.find(recorded.change.section, recorded.change.name);
+            m_notifier.notify(recorded.change.section, recorded.change.name, (pSett ? pSett->getValueVariant() : AppSettingValue_t()));
+        }
+    }
+    recordVersion(std::move(loadChanges));
 
     COMPLOG_OK("Settings loaded");
 }
@@ -152,21 +358,363 @@ void ApplicationSettings::saveSettings(const std::string& configPath) const {
 
     COMPLOG_INFO("Saving settings to file:", configPath);
 
-    Filework::IniFileParser iniParser;
+    // Config is replaced atomically, so crash during save leaves previous file, not partial one
+    std::string iniText;
     for (auto& [settGroup, setts] : m_settingSections) {
-        std::map<std::string, std::string> sectionData;
-        for (auto& pSett : setts) {
-            sectionData[pSett->getName().data()] = pSett->getValueString();
+        iniText += '[' + settGroup + "]\n";
+        for (auto& [settingName, pSett] : setts) {
+            iniText += settingName + '=' + pSett->getValueString() + '\n';
         }
-        iniParser.addSection(settGroup, std::move(sectionData));
     }
 
-    if (!iniParser.write(configPath)) {
-        COMPLOG_ERROR("Failed to save settings:", iniParser.getLastErrorText());
+    if (!AtomicFileWriter::getInstance().writeFile(configPath, iniText, Durability::Full)) {
+        COMPLOG_ERROR("Failed to save settings:", configPath);
         return;
     }
 
     COMPLOG_OK("Settings saved");
 }
 
+bool ApplicationSettings::pushLayer(const std::string &layerName)
+{
+    if (hasLayer(layerName)) {
+        return false;
+    }
+    m_layers.emplace_back(layerName);
+    return true;
+}
+
+bool ApplicationSettings::hasLayer(const std::string &layerName) const
+{
+    return std::any_of(m_layers.begin(), m_layers.end(), [&layerName](const SettingsLayer& layer) {
+        return layer.getName() == layerName;
+    });
+}
+
+bool ApplicationSettings::removeLayer(const std::string &layerName)
+{
+    auto layerIt = std::find_if(m_layers.begin(), m_layers.end(), [&layerName](const SettingsLayer& layer) {
+        return layer.getName() == layerName;
+    });
+    if (layerIt == m_layers.end()) {
+        return false;
+    }
+    auto removedSettings = layerIt->replaceSettings({});
+    m_layers.erase(layerIt);
+    rebuildOverlay(removedSettings);
+    return true;
+}
+
+void ApplicationSettings::clearLayer(const std::string &layerName)
+{
+    if (auto pLayer = findLayer(layerName); pLayer) {
+        replaceLayerSettings(*pLayer, {});
+    }
+}
+
+std::vector<std::string> ApplicationSettings::getLayerNames() const
+{
+    std::vector<std::string> res;
+    res.reserve(m_layers.size());
+    for (auto& layer : m_layers) {
+        res.emplace_back(layer.getName());
+    }
+    return res;
+}
+
+std::shared_ptr<AppSetting> ApplicationSettings::setLayerValue(const std::string &layerName, const std::string &section, const std::string &settingName, const AppSettingValue_t &v)
+{
+    auto pLayer = findLayer(layerName);
+    if (!pLayer) {
+        return {};
+    }
+    auto pSett = pLayer->setValue(section, settingName, v);
+    rebuildOverlayKey(section, settingName);
+    return pSett;
+}
+
+bool ApplicationSettings::removeLayerValue(const std::string &layerName, const std::string &section, const std::string &settingName)
+{
+    auto pLayer = findLayer(layerName);
+    if (!pLayer || !pLayer->removeSetting(section, settingName)) {
+        return false;
+    }
+    rebuildOverlayKey(section, settingName);
+    return true;
+}
+
+bool ApplicationSettings::loadLayerFile(const std::string &layerName, const std::string &configPath)
+{
+    auto pLayer = findLayer(layerName);
+    if (!pLayer) {
+        COMPLOG_ERROR("Settings layer not exist:", layerName);
+        return false;
+    }
+
+    COMPLOG_INFO("Loading settings layer", layerName, "from file:", configPath);
+    Filework::IniFileParser iniParser;
+    if (!iniParser.read(configPath)) {
+        COMPLOG_ERROR("Failed to parse settings layer:", iniParser.getLastErrorText());
+        return false;
+    }
+
+    SettingsLayer newLayer(layerName);
+    for (auto& groupName : iniParser.getSections()) {
+        for (auto& [valueName, value] : iniParser.getSection(groupName)) {
+            newLayer.setRawValue(groupName, valueName, value.data());
+        }
+    }
+    replaceLayerSettings(*pLayer, newLayer.replaceSettings({}));
+    return true;
+}
+
+bool ApplicationSettings::loadLayerEnvironment(const std::string &layerName, const std::string &prefix)
+{
+    auto pLayer = findLayer(layerName);
+    if (!pLayer) {
+        COMPLOG_ERROR("Settings layer not exist:", layerName);
+        return false;
+    }
+
+    SettingsLayer newLayer(layerName);
+    for (char** pEnv = environ; pEnv && *pEnv; ++pEnv) {
+        std::string_view envVar(*pEnv);
+        if (envVar.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        envVar.remove_prefix(prefix.size());
+
+        auto valuePos = envVar.find('=');
+        auto sectionEnd = envVar.substr(0, valuePos).find("__");
+        if (valuePos == std::string_view::npos || sectionEnd == std::string_view::npos) {
+            continue;
+        }
+        newLayer.setRawValue(std::string(envVar.substr(0, sectionEnd)),
+                             std::string(envVar.substr(sectionEnd + 2, valuePos - sectionEnd - 2)),
+                             std::string(envVar.substr(valuePos + 1)));
+    }
+    replaceLayerSettings(*pLayer, newLayer.replaceSettings({}));
+    return true;
+}
+
+bool ApplicationSettings::loadLayerArguments(const std::string &layerName)
+{
+    auto pLayer = findLayer(layerName);
+    if (!pLayer) {
+        COMPLOG_ERROR("Settings layer not exist:", layerName);
+        return false;
+    }
+
+    SettingsLayer newLayer(layerName);
+    for (auto& [argName, argValue] : m_arguments) {
+        auto sectionEnd = argName.find('.');
+        if (!argValue || sectionEnd == std::string::npos) {
+            continue;
+        }
+        newLayer.setValue(argName.substr(0, sectionEnd), argName.substr(sectionEnd + 1), argValue->getValueVariant());
+    }
+    replaceLayerSettings(*pLayer, newLayer.replaceSettings({}));
+    return true;
+}
+
+std::string ApplicationSettings::getSettingSource(const std::string &section, const std::string &settingName) const
+{
+    for (auto layerIt = m_layers.rbegin(); layerIt != m_layers.rend(); ++layerIt) {
+        if (layerIt->getSetting(section, settingName)) {
+            return std::string(layerIt->getName());
+        }
+    }
+    return {};
+}
+
+SettingsLayer *ApplicationSettings::findLayer(std::string_view layerName)
+{
+    for (auto& layer : m_layers) {
+        if (layer.getName() == layerName) {
+            return &layer;
+        }
+    }
+    return nullptr;
+}
+
+void ApplicationSettings::replaceLayerSettings(SettingsLayer &layer, SettingsLayer::SettingsMap_t &&newSettings)
+{
+    auto oldSettings = layer.replaceSettings(std::move(newSettings));
+    rebuildOverlay(oldSettings);
+    rebuildOverlay(layer.getSettings());
+}
+
+void ApplicationSettings::rebuildOverlay(const SettingsLayer::SettingsMap_t &affectedSettings)
+{
+    for (auto& [section, setts] : affectedSettings) {
+        for (auto& [settingName, pSett] : setts) {
+            rebuildOverlayKey(section, settingName);
+        }
+    }
+}
+
+void ApplicationSettings::rebuildOverlayKey(const std::string &section, const std::string &settingName)
+{
+    // Layer value must pass checks of base setting (bounds of NumericSetting, for example)
+    auto pBaseSett = findBaseSetting(section, settingName);
+    for (auto layerIt = m_layers.rbegin(); layerIt != m_layers.rend(); ++layerIt) {
+        auto pSett = layerIt->getSetting(section, settingName);
+        if (!pSett) {
+            continue;
+        }
+        auto rawValue = pSett->getRawValue();
+        auto isValid = (!pBaseSett || (rawValue ? pBaseSett->isValidRawValue(std::string(*rawValue)) :
+                                                  pBaseSett->isValidValue(pSett->getValueVariant())));
+        if (!isValid) {
+            COMPLOG_WARNING("Settings layer", layerIt->getName(), "value is rejected by setting", section + "." + settingName);
+            continue;
+        }
+        m_overlayIndex[section][settingName] = pSett;
+        setEffectiveSetting(section, settingName, pSett, true);
+        return;
+    }
+
+    auto sectionIt = m_overlayIndex.find(section);
+    if (sectionIt != m_overlayIndex.end() && sectionIt->second.erase(settingName) && sectionIt->second.empty()) {
+        m_overlayIndex.erase(sectionIt);
+    }
+
+    // Not overridden, fall back to base setting
+    if (pBaseSett) {
+        setEffectiveSetting(section, settingName, pBaseSett, true);
+        return;
+    }
+    eraseEffectiveSetting(section, settingName);
+}
+
+std::shared_ptr<AppSetting> ApplicationSettings::findBaseSetting(const std::string &section, std::string_view settingName) const
+{
+    auto sectionIt = m_settingSections.find(section);
+    if (sectionIt == m_settingSections.end()) {
+        return {};
+    }
+    auto settIt = sectionIt->second.find(settingName);
+    return (settIt != sectionIt->second.end() ? settIt->second : nullptr);
+}
+
+void ApplicationSettings::setEffectiveSetting(const std::string &section, const std::string &settingName, const std::shared_ptr<AppSetting> &pSetting, bool isNotifying)
+{
+    auto pPrevSetting = m_settingsIndex.find(section, settingName);
+    if (pPrevSetting == pSetting) {
+        return;
+    }
+    if (pPrevSetting) {
+        pPrevSetting->m_pNotifier = nullptr;
+    }
+    pSetting->m_pNotifier = &m_notifier;
+    pSetting->m_section = section;
+    m_settingsIndex.insert(section, settingName, pSetting);
+
+    if (isNotifying) {
+        m_notifier.notify(section, settingName, pSetting->getValueVariant());
+    }
+}
+
+void ApplicationSettings::eraseEffectiveSetting(const std::string &section, const std::string &settingName)
+{
+    auto pPrevSetting = m_settingsIndex.find(section, settingName);
+    if (!pPrevSetting) {
+        return;
+    }
+    pPrevSetting->m_pNotifier = nullptr;
+    m_settingsIndex.erase(section, settingName);
+    m_notifier.notify(section, settingName, {});
+}
+
+bool ApplicationSettings::isInLayers(const std::string &section, std::string_view settingName) const
+{
+    return std::any_of(m_layers.begin(), m_layers.end(), [&](const SettingsLayer& layer) {
+        return (layer.getSetting(section, settingName) != nullptr);
+    });
+}
+
+bool ApplicationSettings::commitTransaction(const SettingsTransaction &transaction)
+{
+    if (transaction.empty()) {
+        return true;
+    }
+
+    SettingsNotifier::Batch notifyBatch(m_notifier);
+    std::unique_lock lock(m_transactionMx);
+
+    // Values are checked before any change, so rejected transaction is not visible to anybody.
+    // Transaction changes base settings, so values are checked by their rules even if layer overrides key
+    for (auto& [key, value] : transaction.m_stagedChanges) {
+        auto pSett = findBaseSetting(key.first, key.second);
+        if (value && pSett && !pSett->isValidValue(*value)) {
+            COMPLOG_ERROR("Settings transaction rejected, invalid value of", key.first + "." + key.second);
+            return false;
+        }
+    }
+
+    auto notifyBatchSize = m_notifier.getBatchSize();
+    std::vector<SettingsVersion::RecordedChange> appliedChanges;
+    for (auto& [key, value] : transaction.m_stagedChanges) {
+        auto pSett = findBaseSetting(key.first, key.second);
+        std::optional<AppSettingValue_t> prevValue;
+        if (pSett) {
+            prevValue = pSett->getValueVariant();
+        }
+        if (prevValue == value) {
+            continue;
+        }
+
+        if (!applyChange(key.first, key.second, value)) {
+            COMPLOG_ERROR("Settings transaction rejected, invalid value of", key.first + "." + key.second);
+            for (auto changeIt = appliedChanges.rbegin(); changeIt != appliedChanges.rend(); ++changeIt) {
+                applyChange(changeIt->change.section, changeIt->change.name, changeIt->change.oldValue);
+            }
+            m_notifier.dropBatchChanges(notifyBatchSize); // Subscribers see neither applied nor reverted values
+            return false;
+        }
+        appliedChanges.push_back({{key.first, key.second, std::move(prevValue), value}});
+    }
+    recordVersion(std::move(appliedChanges));
+    return true;
+}
+
+bool ApplicationSettings::applyChange(const std::string &section, const std::string &settingName, const std::optional<AppSettingValue_t> &value)
+{
+    auto pSett = findBaseSetting(section, settingName);
+    if (!value) {
+        return (!pSett || removeSetting(section, settingName));
+    }
+    if (!pSett) {
+        pSett = addSetting(section, settingName);
+    }
+    if (!pSett->setValue(*value)) {
+        return false;
+    }
+    if (isInLayers(section, settingName)) {
+        rebuildOverlayKey(section, settingName); // Base value is not effective, layer value stays
+    }
+    return true;
+}
+
+bool ApplicationSettings::isVersionInHistory(uint64_t version, bool isLocking) const
+{
+    std::shared_lock lock(m_transactionMx, std::defer_lock);
+    if (isLocking) {
+        lock.lock();
+    }
+    auto oldestAvailable = (m_versions.empty() ? m_currentVersion : m_versions.front().id - 1);
+    return (version >= oldestAvailable && version <= m_currentVersion);
+}
+
+void ApplicationSettings::recordVersion(std::vector<SettingsVersion::RecordedChange> &&changes)
+{
+    if (changes.empty()) {
+        return;
+    }
+    m_versions.push_back({++m_currentVersion, std::move(changes)});
+    while (m_versions.size() > m_historyDepth) {
+        m_versions.pop_front();
+    }
+}
+
 }
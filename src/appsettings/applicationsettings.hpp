@@ -6,9 +6,18 @@
 #include <memory>
 #include <map>
 #include <set>
+#include <vector>
+#include <functional>
+#include <deque>
+#include <shared_mutex>
 
 #include "appsettingscommon.hpp"
 #include "appsetting.hpp"
+#include "settingslayer.hpp"
+#include "settingsindex.hpp"
+#include "settingsnotifier.hpp"
+#include "settingstransaction.hpp"
+#include "scopedsettingoverride.hpp"
 
 
 namespace Common {
@@ -19,10 +28,80 @@ public:
     ~ApplicationSettings();
 
     bool hasSetting(const std::string& section, const std::string& settingName);
+    /**
+     * @brief addSetting    Add base setting. Base setting with the same name is replaced
+     */
     std::shared_ptr<AppSetting> addSetting(const std::string& section, const std::string& settingName);
     void addSetting(const std::string& section, const std::shared_ptr<AppSetting> &pSetting);
+
+    /**
+     * @brief getSetting    Get effective setting
+     * @note Overrides of current thread (see @ref ScopedSettingOverride) are checked first
+     */
     std::shared_ptr<AppSetting> getSetting(const std::string& section, const std::string& settingName) const;
 
+    /**
+     * @brief removeSetting Remove base setting. Overriding layers are not changed
+     * @return              false if setting not exist
+     */
+    bool removeSetting(const std::string& section, const std::string& settingName);
+
+    // Транзакции и история версий. Версия создается при commit транзакции и при loadSettings
+
+    SettingsTransaction beginTransaction();
+
+    /**
+     * @brief lockShared    Lock to read several settings consistently, transactions are not committed while locked
+     * @return
+     */
+    std::shared_lock<std::shared_mutex> lockShared() const;
+
+    uint64_t getVersion() const;
+
+    /**
+     * @brief setHistoryDepth   Set count of last versions to keep for diff and rollback
+     * @param depth             Default is 16
+     */
+    void setHistoryDepth(std::size_t depth);
+
+    /**
+     * @brief diffVersions  Get changes between versions (from older to newer or vice versa)
+     * @return              Changes, ordered by section and name. Empty if versions are out of history
+     */
+    std::vector<SettingVersionChange> diffVersions(uint64_t fromVersion, uint64_t toVersion) const;
+
+    /**
+     * @brief rollbackTo    Return settings to state of version. Rollback creates new version
+     * @return              false if version is out of history or values were rejected
+     */
+    bool rollbackTo(uint64_t version);
+
+    /**
+     * @brief getNotifier   Get notifier to subscribe for changes of effective settings
+     * @note Changes, made by loadSettings(), are delivered as one batch
+     */
+    SettingsNotifier& getNotifier();
+
+    /**
+     * @brief findSettings  Find effective settings which full key "<section>.<name>" matches glob pattern
+     * @param globPattern   See @ref SettingsIndex::findMatching, for example "cache.*.size"
+     * @return              Lazy range of index entries, ordered by full key. Invalidated by any change of settings
+     */
+    SettingsIndex::Range findSettings(std::string_view globPattern) const;
+
+    /**
+     * @brief findSettingsByPrefix  Find effective settings which full key "<section>.<name>" starts with prefix
+     * @param prefix                For example "plugins."
+     * @return                      Lazy range of index entries, ordered by full key. Invalidated by any change of settings
+     */
+    SettingsIndex::Range findSettingsByPrefix(std::string_view prefix) const;
+
+    /**
+     * @brief forEachSetting    Iterate over effective settings (base settings with layers applied), ordered by full key
+     * @param callback          Called once for every setting with its section
+     */
+    void forEachSetting(const std::function<void(const std::string&, const std::shared_ptr<AppSetting>&)>& callback) const;
+
     // Работа с файлом настроек и классом
     static ApplicationSettings& getInstance();
 
@@ -30,14 +109,97 @@ public:
     std::shared_ptr<AppSetting> getArgument(const std::string& valName) const;
 
     // Работа с файлом настроек для внешних целей (загрузка профилей, например)
+    // Ранее добавленные настройки с ключами из файла сохраняются и сами проверяют значения (типизированные, например),
+    // отклоненное значение не применяется. Остальные ключи файла загружаются как AppSetting
     void loadSettings(const std::string& configPath = {});
     void saveSettings(const std::string& configPath = {}) const;
 
+    // Слои конфигурации поверх основных настроек. Слой, добавленный позже, имеет больший приоритет.
+    // Основные настройки (addSetting, loadSettings) являются нижним слоем и только они сохраняются в saveSettings
+
+    /**
+     * @brief pushLayer Add layer on top of the stack
+     * @param layerName Unique name of layer
+     * @return          false if layer with such name already exist
+     */
+    bool pushLayer(const std::string& layerName);
+    bool hasLayer(const std::string& layerName) const;
+    bool removeLayer(const std::string& layerName);
+    void clearLayer(const std::string& layerName);
+
+    /**
+     * @brief getLayerNames Get names of layers in priority order (lowest first)
+     * @return
+     */
+    std::vector<std::string> getLayerNames() const;
+
+    /**
+     * @brief setLayerValue Set value of setting in layer
+     * @return              Setting stored in layer. Empty if layer not exist
+     */
+    std::shared_ptr<AppSetting> setLayerValue(const std::string& layerName, const std::string& section, const std::string& settingName, const AppSettingValue_t& v);
+    bool removeLayerValue(const std::string& layerName, const std::string& section, const std::string& settingName);
+
+    /**
+     * @brief loadLayerFile Replace layer contents with settings from INI file
+     * @return              false if layer not exist or file can not be parsed. Layer stays untouched in this case
+     */
+    bool loadLayerFile(const std::string& layerName, const std::string& configPath);
+
+    /**
+     * @brief loadLayerEnvironment  Replace layer contents with environment variables named <prefix><section>__<setting>
+     * @param prefix                Variables prefix, for example "MYAPP_"
+     * @return                      false if layer not exist
+     */
+    bool loadLayerEnvironment(const std::string& layerName, const std::string& prefix);
+
+    /**
+     * @brief loadLayerArguments    Replace layer contents with arguments named <section>.<setting> (see @ref parseArguments)
+     * @return                      false if layer not exist
+     */
+    bool loadLayerArguments(const std::string& layerName);
+
+    /**
+     * @brief getSettingSource  Get name of layer which provides setting value
+     * @return                  Name of layer, empty if setting is taken from base settings or not exist
+     */
+    std::string getSettingSource(const std::string& section, const std::string& settingName) const;
+
 private:
-    std::map<std::string, std::set<std::shared_ptr<AppSetting> > > m_settingSections;
+    // Base settings: section -> name -> setting. Ordered, so settings are saved in stable order
+    SettingsLayer::SettingsMap_t m_settingSections;
     std::string m_currentConfigsPath {"default.ini"};
 
     std::map<std::string, std::shared_ptr<AppSetting> > m_arguments;
+
+    // Layers, lowest priority first, and flattened index of overridden settings: section -> name -> winning setting
+    std::vector<SettingsLayer> m_layers;
+    SettingsLayer::SettingsMap_t m_overlayIndex;
+
+    // Sorted index of effective settings, used for lookups and queries
+    SettingsIndex m_settingsIndex;
+    SettingsNotifier m_notifier;
+
+    // Versions history, each version stores only changed settings
+    mutable std::shared_mutex   m_transactionMx;
+    std::deque<SettingsVersion> m_versions;
+    uint64_t                    m_currentVersion {0};
+    std::size_t                 m_historyDepth {16};
+
+    SettingsLayer* findLayer(std::string_view layerName);
+    void replaceLayerSettings(SettingsLayer& layer, SettingsLayer::SettingsMap_t&& newSettings);
+    void rebuildOverlay(const SettingsLayer::SettingsMap_t& affectedSettings);
+    void rebuildOverlayKey(const std::string& section, const std::string& settingName);
+    std::shared_ptr<AppSetting> findBaseSetting(const std::string& section, std::string_view settingName) const;
+    bool isInLayers(const std::string& section, std::string_view settingName) const;
+    void setEffectiveSetting(const std::string& section, const std::string& settingName, const std::shared_ptr<AppSetting>& pSetting, bool isNotifying);
+    void eraseEffectiveSetting(const std::string& section, const std::string& settingName);
+
+    friend class SettingsTransaction;
+    bool commitTransaction(const SettingsTransaction& transaction);
+    bool applyChange(const std::string& section, const std::string& settingName, const std::optional<AppSettingValue_t>& value);
+    void recordVersion(std::vector<SettingsVersion::RecordedChange>&& changes);
+    bool isVersionInHistory(uint64_t version, bool isLocking = true) const;
 };
 
 } // namespace Common
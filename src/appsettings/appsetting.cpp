@@ -1,7 +1,34 @@
 #include "appsetting.hpp"
 
+#include "settingsnotifier.hpp"
+
+#include <thread>
+
 namespace Common {
 
+AppSetting::AppSetting(const AppSetting &other)
+{
+    *this = other;
+}
+
+AppSetting &AppSetting::operator=(const AppSetting &other)
+{
+    if (this == &other) {
+        return *this;
+    }
+    m_name = other.m_name;
+    m_description = other.m_description;
+    other.fillCache(ValueParsed);
+    uint8_t state;
+    lockCache(state, 0);
+    m_rawValue = other.m_rawValue;
+    m_hasRawValue = other.m_hasRawValue;
+    m_value = other.m_value;
+    m_valueString.clear();
+    m_cacheState.store(ValueParsed, std::memory_order_release);
+    return *this;
+}
+
 void AppSetting::setName(const std::string &name)
 {
     m_name = name;
@@ -24,18 +51,116 @@ std::string_view AppSetting::getDescription() const
 
 bool AppSetting::setValue(const AppSettingValue_t &v)
 {
+    uint8_t state;
+    lockCache(state, 0); // Reader may fill cache now
     m_value = v;
+    m_rawValue.clear();
+    m_hasRawValue = false;
+    m_cacheState.store(ValueParsed, std::memory_order_release);
+    notifyChanged();
     return true;
 }
 
+bool AppSetting::setRawValue(const std::string &rawValue)
+{
+    uint8_t state;
+    lockCache(state, 0);
+    m_rawValue = rawValue;
+    m_hasRawValue = true;
+    m_cacheState.store(0, std::memory_order_release);
+    notifyChanged();
+    return true;
+}
+
+bool AppSetting::isValidValue(const AppSettingValue_t &) const
+{
+    return true;
+}
+
+bool AppSetting::isValidRawValue(const std::string &) const
+{
+    return true;
+}
+
+std::optional<std::string_view> AppSetting::getRawValue() const
+{
+    if (!m_hasRawValue) {
+        return std::nullopt;
+    }
+    return m_rawValue;
+}
+
 bool AppSetting::isSet() const
 {
-    return !std::holds_alternative<std::monostate>(m_value) && (!getValueString().empty()); // Empty string also mean not set
+    auto state = m_cacheState.load(std::memory_order_acquire);
+    if (!(state & ValueParsed)) {
+        return !m_rawValue.empty(); // Converted from non-empty text, value is never empty
+    }
+    if (auto pStr = std::get_if<std::string>(&m_value); pStr) {
+        return !pStr->empty(); // Empty string also mean not set
+    }
+    return !std::holds_alternative<std::monostate>(m_value);
 }
 
 std::string AppSetting::getValueString() const
 {
-    return valueToString(m_value);
+    fillCache(StringCached);
+    return m_valueString;
+}
+
+const AppSettingValue_t &AppSetting::getValueVariant() const
+{
+    fillCache(ValueParsed);
+    return m_value;
+}
+
+void AppSetting::fillCache(uint8_t requiredFlag) const
+{
+    auto state = m_cacheState.load(std::memory_order_acquire);
+    if (state & requiredFlag) {
+        return;
+    }
+
+    // Other readers wait until cache is filled
+    if (!lockCache(state, requiredFlag)) {
+        return;
+    }
+
+    if (!(state & ValueParsed)) {
+        m_value = valueFromString(m_rawValue);
+        state |= ValueParsed;
+    }
+    if (requiredFlag == StringCached) {
+        m_valueString = valueToString(m_value);
+        state |= StringCached;
+    }
+    m_cacheState.store(state, std::memory_order_release);
+}
+
+bool AppSetting::lockCache(uint8_t &state, uint8_t requiredFlag) const
+{
+    state = m_cacheState.load(std::memory_order_relaxed);
+    while (true) {
+        if (state & requiredFlag) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return false;
+        }
+        if (state & CacheLocked) {
+            std::this_thread::yield();
+            state = m_cacheState.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (m_cacheState.compare_exchange_weak(state, state | CacheLocked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void AppSetting::notifyChanged()
+{
+    if (m_pNotifier && m_pNotifier->hasSubscribers()) {
+        m_pNotifier->notify(m_section, m_name, getValueVariant());
+    }
 }
 
 } // namespace Common
@@ -2,16 +2,26 @@
 
 #include "appsettingscommon.hpp"
 
+#include <atomic>
+#include <optional>
 #include <string>
 
 namespace Common {
 
+class SettingsNotifier;
+
 /**
  * @brief The AppSetting class Basic value in settings
+ * @note Value, set from source text (@ref setRawValue), is converted on first typed access.
+ *       Converted value and its string form are cached until value is changed
  */
 class AppSetting
 {
 public:
+    AppSetting() = default;
+    AppSetting(const AppSetting& other);
+    AppSetting& operator=(const AppSetting& other);
+
     void setName(const std::string& name);
     std::string_view getName() const;
 
@@ -19,19 +29,84 @@ public:
     std::string_view getDescription() const;
 
     virtual bool setValue(const AppSettingValue_t& v);
+
+    /**
+     * @brief setRawValue   Set value from source text (config file, arguments). Text is converted on first access
+     * @param rawValue      Text to convert with @ref valueFromString()
+     * @return              true if value accepted
+     */
+    virtual bool setRawValue(const std::string& rawValue);
+
+    /**
+     * @brief isValidValue      Check value by rules of @ref setValue() without changing setting
+     */
+    virtual bool isValidValue(const AppSettingValue_t& v) const;
+
+    /**
+     * @brief isValidRawValue   Check source text by rules of @ref setRawValue() without changing setting
+     */
+    virtual bool isValidRawValue(const std::string& rawValue) const;
+
+    /**
+     * @brief getRawValue   Get source text of value
+     * @return              std::nullopt if value was set by @ref setValue()
+     */
+    std::optional<std::string_view> getRawValue() const;
     bool isSet() const;
 
     template <typename T>
     T getValue() const {
-        return std::get<T>(m_value);
+        return std::get<T>(getValueVariant());
     }
+
+    /**
+     * @brief getArray  Get array value without copying
+     * @return          View of array, valid until value is changed
+     * @throws std::bad_variant_access if value is not std::vector<T>
+     */
+    template <typename T>
+    ArrayView_t<T> getArray() const {
+        auto& values = std::get<std::vector<T> >(getValueVariant());
+        return ArrayView_t<T>(values.data(), values.size());
+    }
+
     std::string getValueString() const;
+    const AppSettingValue_t& getValueVariant() const;
 
 private:
+    friend class ApplicationSettings;
+
+    enum CacheFlags : uint8_t
+    {
+        ValueParsed     = 1 << 0,
+        StringCached    = 1 << 1,
+        CacheLocked     = 1 << 2,
+    };
+
     std::string m_name;
     std::string m_description;
 
-    AppSettingValue_t m_value;
+    // Value caches are filled in const methods, so they are guarded by lock bit of state
+    std::string                     m_rawValue;
+    bool                            m_hasRawValue {false};
+    mutable AppSettingValue_t       m_value;
+    mutable std::string             m_valueString;
+    mutable std::atomic<uint8_t>    m_cacheState {ValueParsed};
+
+    // Set by ApplicationSettings while setting is effective one
+    SettingsNotifier*   m_pNotifier {nullptr};
+    std::string         m_section;
+
+    void fillCache(uint8_t requiredFlag) const;
+
+    /**
+     * @brief lockCache     Take lock bit of state. Writers of value take it too, so reader never fills cache from half-written value
+     * @param state         State before lock
+     * @param requiredFlag  If flag is set by other thread, lock is not needed
+     * @return              false if requiredFlag is set, lock is not taken in this case
+     */
+    bool lockCache(uint8_t& state, uint8_t requiredFlag) const;
+    void notifyChanged();
 };
 
 } // namespace Common
@@ -2,6 +2,15 @@
 
 #include <variant>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <charconv>
+
+#if __has_include(<span>)
+#include <span>
+#endif
 
 namespace Common
 {
@@ -12,13 +21,47 @@ using AppSettingValue_t =
         std::monostate,
         std::string,
         int64_t,
-        double>;
+        double,
+        std::vector<int64_t>,
+        std::vector<double>,
+        std::vector<std::string> >;
+
+
+#ifdef __cpp_lib_span
+template <typename T>
+using ArrayView_t = std::span<const T>;
+#else
+/**
+ * @brief The ArrayView class Read-only view of contiguous array (replacement of std::span before C++20)
+ */
+template <typename T>
+class ArrayView
+{
+public:
+    ArrayView() = default;
+    ArrayView(const T* pData, std::size_t size) : m_pData {pData}, m_size {size} {}
+
+    const T* data() const { return m_pData; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return (m_size == 0); }
+
+    const T* begin() const { return m_pData; }
+    const T* end() const { return m_pData + m_size; }
+    const T& operator[](std::size_t i) const { return m_pData[i]; }
+
+private:
+    const T*    m_pData {nullptr};
+    std::size_t m_size {0};
+};
+template <typename T>
+using ArrayView_t = ArrayView<T>;
+#endif
 
 
 /**
  * @brief valueToString Converts value into string
  * @param val           Input value
- * @return              Result of conversion. If null or empty string, return ""
+ * @return              Result of conversion. If null or empty string, return "". Arrays are joined with ','
  */
 inline std::string valueToString(const AppSettingValue_t& val) {
     if (std::holds_alternative<std::monostate>(val)) {
@@ -33,7 +76,93 @@ inline std::string valueToString(const AppSettingValue_t& val) {
     if (std::holds_alternative<std::string>(val)) {
         return std::get<std::string>(val); // TODO: Use '\"' ?
     }
-    return {};
+
+    std::string res;
+    auto joinValues = [&res](const auto& values, auto&& elementToString) {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (i != 0) {
+                res += ',';
+            }
+            res += elementToString(values[i]);
+        }
+    };
+    if (auto pInts = std::get_if<std::vector<int64_t> >(&val); pInts) {
+        joinValues(*pInts, [](int64_t v) { return std::to_string(v); });
+    } else if (auto pDoubles = std::get_if<std::vector<double> >(&val); pDoubles) {
+        joinValues(*pDoubles, [](double v) { return std::to_string(v); });
+    } else if (auto pStrings = std::get_if<std::vector<std::string> >(&val); pStrings) {
+        joinValues(*pStrings, [](const std::string& v) -> const std::string& { return v; });
+    }
+    return res;
 }
 
-}
\ No newline at end of file
+/**
+ * @brief parseArrayValue   Parse comma-separated list in one pass. Spaces around elements are skipped
+ * @param text              Input text, for example "1, 2, 3"
+ * @param res               Parsed elements
+ * @return                  false if any element is empty or can not be converted to T
+ */
+template <typename T>
+bool parseArrayValue(std::string_view text, std::vector<T>& res) {
+    res.clear();
+    res.reserve(std::count(text.begin(), text.end(), ',') + 1);
+
+    std::size_t elementStart {0};
+    while (true) {
+        auto elementEnd = std::min(text.find(',', elementStart), text.size());
+        auto element = text.substr(elementStart, elementEnd - elementStart);
+        element.remove_prefix(std::min(element.find_first_not_of(' '), element.size()));
+        element.remove_suffix(element.size() - std::min(element.find_last_not_of(' ') + 1, element.size()));
+        if (element.empty()) {
+            return false;
+        }
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            res.emplace_back(element);
+        } else {
+            T v {};
+            auto [pEnd, ec] = std::from_chars(element.data(), element.data() + element.size(), v);
+            if (ec != std::errc() || pEnd != element.data() + element.size()) {
+                return false;
+            }
+            res.push_back(v);
+        }
+
+        if (elementEnd == text.size()) {
+            return true;
+        }
+        elementStart = elementEnd + 1;
+    }
+}
+
+/**
+ * @brief valueFromString   Converts string from config into value
+ * @param str               Input string
+ * @return                  Comma-separated numbers are converted to array of int64_t (or double, if any has dot).
+ *                          Otherwise int64_t if no dots in string, double if one dot, string otherwise or if conversion failed
+ */
+inline AppSettingValue_t valueFromString(const std::string& str) {
+    if (str.find(',') != std::string::npos) {
+        if (std::vector<int64_t> ints; parseArrayValue(str, ints)) {
+            return ints;
+        }
+        if (std::vector<double> doubles; parseArrayValue(str, doubles)) {
+            return doubles;
+        }
+        return str;
+    }
+
+    auto dotCount = std::count(str.begin(), str.end(), '.');
+    try {
+        if (dotCount == 0) {
+            return static_cast<int64_t>(std::stoll(str));
+        }
+        if (dotCount == 1) {
+            return std::stod(str);
+        }
+    } catch ([[maybe_unused]] std::logic_error& ex) { // Ignore exception, it's normal
+    }
+    return str;
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "appsetting.hpp"
+
+#include <limits>
+
+namespace Common
+{
+
+/**
+ * @brief The ArraySetting class Setting with contiguous array value. Source text is comma-separated list
+ */
+template <typename ValueT>
+class ArraySetting : public AppSetting
+{
+public:
+    virtual bool setValue(const AppSettingValue_t& v) override {
+        if (!isValidValue(v)) {
+            return false;
+        }
+        return AppSetting::setValue(v);
+    }
+
+    virtual bool setRawValue(const std::string& rawValue) override {
+        std::vector<ValueT> values;
+        if (!rawValue.empty() && !parseArrayValue(rawValue, values)) {
+            return false;
+        }
+        return setValue(std::move(values)); // Parsed right away to check elements
+    }
+
+    virtual bool isValidValue(const AppSettingValue_t& v) const override {
+        if (std::holds_alternative<std::monostate>(v)) {
+            return true;
+        }
+        auto pValues = std::get_if<std::vector<ValueT> >(&v);
+        return (pValues && isValid(*pValues));
+    }
+
+    virtual bool isValidRawValue(const std::string& rawValue) const override {
+        std::vector<ValueT> values;
+        return (rawValue.empty() || (parseArrayValue(rawValue, values) && isValid(values)));
+    }
+
+    ArrayView_t<ValueT> getValues() const {
+        return getArray<ValueT>();
+    }
+
+protected:
+    virtual bool isValid(const std::vector<ValueT>& /*values*/) const {
+        return true;
+    }
+};
+
+/**
+ * @brief The NumericArraySetting class Array setting with bounds, checked for every element
+ */
+template <typename ValueT>
+class NumericArraySetting : public ArraySetting<ValueT>
+{
+    ValueT m_minV {std::numeric_limits<ValueT>::lowest()};
+    ValueT m_maxV {std::numeric_limits<ValueT>::max()};
+public:
+    void setMin(ValueT minV) {
+        m_minV = minV;
+        clampValues();
+    }
+    void setMax(ValueT maxV) {
+        m_maxV = maxV;
+        clampValues();
+    }
+
+    ValueT getMin() const {
+        return m_minV;
+    }
+    ValueT getMax() const {
+        return m_maxV;
+    }
+
+protected:
+    virtual bool isValid(const std::vector<ValueT>& values) const override {
+        return std::all_of(values.begin(), values.end(), [this](ValueT v) {
+            return (v >= m_minV && v <= m_maxV);
+        });
+    }
+
+private:
+    void clampValues() {
+        if (!this->isSet()) {
+            return;
+        }
+        auto values = this->template getValue<std::vector<ValueT> >();
+        for (auto& v : values) {
+            v = std::clamp(v, m_minV, std::max(m_minV, m_maxV));
+        }
+        this->setValue(std::move(values));
+    }
+};
+using AppIntArraySetting = NumericArraySetting<int64_t>;
+using AppDoubleArraySetting = NumericArraySetting<double>;
+using AppStringListSetting = ArraySetting<std::string>;
+
+}
@@ -42,17 +42,26 @@ public:
     }
 
     virtual bool setValue(const AppSettingValue_t& v) override {
-        if (std::holds_alternative<std::monostate>(v)) {
-            return AppSetting::setValue(v);
-        }
-        if (!std::holds_alternative<ValueT>(v)) {
+        if (!isValidValue(v)) {
             return false;
         }
-        auto& numV = std::get<ValueT>(v);
-        if (numV < m_minV || numV > m_maxV) {
-            return false;
+        return AppSetting::setValue(v);
+    }
+
+    virtual bool setRawValue(const std::string& rawValue) override {
+        return setValue(valueFromString(rawValue)); // Value must be checked for bounds right away
+    }
+
+    virtual bool isValidValue(const AppSettingValue_t& v) const override {
+        if (std::holds_alternative<std::monostate>(v)) {
+            return true;
         }
-        return AppSetting::setValue(numV);
+        auto pNumV = std::get_if<ValueT>(&v);
+        return (pNumV && *pNumV >= m_minV && *pNumV <= m_maxV);
+    }
+
+    virtual bool isValidRawValue(const std::string& rawValue) const override {
+        return isValidValue(valueFromString(rawValue));
     }
 };
 using AppIntSetting = NumericSetting<int64_t>;
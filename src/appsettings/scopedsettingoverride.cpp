@@ -0,0 +1,35 @@
+#include "scopedsettingoverride.hpp"
+
+namespace Common {
+
+ScopedSettingOverride::ScopedSettingOverride(const std::string &section, const std::string &settingName, const AppSettingValue_t &value) :
+    m_section {section},
+    m_pSetting {std::make_shared<AppSetting>()},
+    m_pPrev {s_pThreadTop}
+{
+    m_pSetting->setName(settingName);
+    m_pSetting->setValue(value);
+    s_pThreadTop = this;
+}
+
+ScopedSettingOverride::~ScopedSettingOverride()
+{
+    s_pThreadTop = m_pPrev;
+}
+
+std::shared_ptr<AppSetting> ScopedSettingOverride::getSetting() const
+{
+    return m_pSetting;
+}
+
+std::shared_ptr<AppSetting> ScopedSettingOverride::findOverride(std::string_view section, std::string_view settingName)
+{
+    for (auto pOverride = s_pThreadTop; pOverride; pOverride = pOverride->m_pPrev) {
+        if (pOverride->m_section == section && pOverride->m_pSetting->getName() == settingName) {
+            return pOverride->m_pSetting;
+        }
+    }
+    return {};
+}
+
+} // namespace Common
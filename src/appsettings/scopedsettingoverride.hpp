@@ -0,0 +1,53 @@
+#pragma once
+
+#include "appsetting.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Common {
+
+/**
+ * @brief The ScopedSettingOverride class Overrides setting for current thread while object exists
+ * @note Override is visible only through ApplicationSettings::getSetting() and hasSetting() of the same thread.
+ *       Nested overrides of the same setting shadow outer ones. Objects must be destroyed in reverse order of creation,
+ *       which is guaranteed when they are used as local variables
+ */
+class ScopedSettingOverride : public boost::noncopyable
+{
+public:
+    ScopedSettingOverride(const std::string& section, const std::string& settingName, const AppSettingValue_t& value);
+    ~ScopedSettingOverride();
+
+    /**
+     * @brief getSetting    Get setting, which is used as override
+     * @return
+     */
+    std::shared_ptr<AppSetting> getSetting() const;
+
+    /**
+     * @brief hasActiveOverrides    Check if current thread has any override
+     * @return
+     */
+    static bool hasActiveOverrides() {
+        return (s_pThreadTop != nullptr);
+    }
+
+    /**
+     * @brief findOverride  Find override of setting for current thread
+     * @return              Empty if setting is not overridden
+     */
+    static std::shared_ptr<AppSetting> findOverride(std::string_view section, std::string_view settingName);
+
+private:
+    std::string                 m_section;
+    std::shared_ptr<AppSetting> m_pSetting;
+    ScopedSettingOverride*      m_pPrev;
+
+    // Stack of active overrides of thread, top is the last created
+    static inline thread_local ScopedSettingOverride* s_pThreadTop {nullptr};
+};
+
+} // namespace Common
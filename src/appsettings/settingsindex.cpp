@@ -0,0 +1,213 @@
+#include "settingsindex.hpp"
+
+namespace Common {
+
+namespace {
+
+/**
+ * @brief compareFullKey    Compare full key with "<section>.<name>" without concatenation
+ * @return                  <0 if full key is less, 0 if equal, >0 if greater
+ */
+int compareFullKey(std::string_view fullKey, std::string_view section, std::string_view name) {
+    auto sectionPart = fullKey.substr(0, section.size());
+    if (auto cmp = sectionPart.compare(section); cmp != 0 || fullKey.size() == section.size()) {
+        return (cmp != 0 ? cmp : -1);
+    }
+    fullKey.remove_prefix(section.size());
+    if (fullKey.front() != '.') {
+        return (static_cast<unsigned char>(fullKey.front()) < static_cast<unsigned char>('.') ? -1 : 1);
+    }
+    fullKey.remove_prefix(1);
+    return fullKey.compare(name);
+}
+
+std::string makeFullKey(std::string_view section, std::string_view name) {
+    std::string res;
+    res.reserve(section.size() + name.size() + 1);
+    res.append(section).append(1, '.').append(name);
+    return res;
+}
+
+} // namespace
+
+
+bool SettingsIndex::KeyLess::operator()(const std::string &a, const std::string &b) const
+{
+    return a < b;
+}
+
+bool SettingsIndex::KeyLess::operator()(const std::string &a, const SplitKey &b) const
+{
+    return compareFullKey(a, b.section, b.name) < 0;
+}
+
+bool SettingsIndex::KeyLess::operator()(const SplitKey &a, const std::string &b) const
+{
+    return compareFullKey(b, a.section, a.name) > 0;
+}
+
+
+SettingsIndex::Iterator::Iterator(const Range *pRange, Map_t::const_iterator it) :
+    m_pRange {pRange},
+    m_it {it}
+{
+    skipNotMatching();
+}
+
+SettingsIndex::Iterator &SettingsIndex::Iterator::operator++()
+{
+    ++m_it;
+    skipNotMatching();
+    return *this;
+}
+
+SettingsIndex::Iterator SettingsIndex::Iterator::operator++(int)
+{
+    auto res = *this;
+    ++(*this);
+    return res;
+}
+
+void SettingsIndex::Iterator::skipNotMatching()
+{
+    if (m_pRange->m_globPattern.empty()) {
+        return;
+    }
+    while (m_it != m_pRange->m_last && !isGlobMatch(m_it->first, m_pRange->m_globPattern)) {
+        ++m_it;
+    }
+}
+
+
+SettingsIndex::Range::Range(Map_t::const_iterator first, Map_t::const_iterator last, std::string globPattern) :
+    m_first {first},
+    m_last {last},
+    m_globPattern {std::move(globPattern)}
+{
+
+}
+
+SettingsIndex::Iterator SettingsIndex::Range::begin() const
+{
+    return Iterator(this, m_first);
+}
+
+SettingsIndex::Iterator SettingsIndex::Range::end() const
+{
+    return Iterator(this, m_last);
+}
+
+bool SettingsIndex::Range::empty() const
+{
+    return (begin() == end());
+}
+
+
+void SettingsIndex::insert(const std::string &section, const std::string &settingName, const std::shared_ptr<AppSetting> &pSetting)
+{
+    auto entryIt = findEntry(section, settingName);
+    if (entryIt != m_entries.end()) {
+        entryIt = m_entries.erase(entryIt);
+    }
+    m_entries.emplace_hint(entryIt, makeFullKey(section, settingName), Entry {section, pSetting});
+}
+
+bool SettingsIndex::erase(std::string_view section, std::string_view settingName)
+{
+    auto entryIt = findEntry(section, settingName);
+    if (entryIt == m_entries.end()) {
+        return false;
+    }
+    m_entries.erase(entryIt);
+    return true;
+}
+
+void SettingsIndex::clear()
+{
+    m_entries.clear();
+}
+
+std::shared_ptr<AppSetting> SettingsIndex::find(std::string_view section, std::string_view settingName) const
+{
+    auto entryIt = findEntry(section, settingName);
+    if (entryIt == m_entries.end()) {
+        return {};
+    }
+    return entryIt->second.pSetting;
+}
+
+std::size_t SettingsIndex::size() const
+{
+    return m_entries.size();
+}
+
+SettingsIndex::Range SettingsIndex::all() const
+{
+    return Range(m_entries.begin(), m_entries.end(), {});
+}
+
+SettingsIndex::Range SettingsIndex::findPrefix(std::string_view prefix) const
+{
+    return Range(m_entries.lower_bound(std::string(prefix)), prefixEnd(prefix), {});
+}
+
+SettingsIndex::Range SettingsIndex::findMatching(std::string_view globPattern) const
+{
+    auto prefix = globPattern.substr(0, globPattern.find_first_of("*?"));
+    if (prefix.size() == globPattern.size()) {
+        auto range = m_entries.equal_range(std::string(globPattern));
+        return Range(range.first, range.second, {});
+    }
+    return Range(m_entries.lower_bound(std::string(prefix)), prefixEnd(prefix), std::string(globPattern));
+}
+
+bool SettingsIndex::isGlobMatch(std::string_view str, std::string_view globPattern)
+{
+    while (!globPattern.empty()) {
+        if (globPattern.front() == '*') {
+            bool isCrossingDots = (globPattern.size() > 1 && globPattern[1] == '*');
+            globPattern.remove_prefix(isCrossingDots ? 2 : 1);
+            for (std::size_t starLength = 0; ; ++starLength) {
+                if (isGlobMatch(str.substr(starLength), globPattern)) {
+                    return true;
+                }
+                if (starLength == str.size() || (!isCrossingDots && str[starLength] == '.')) {
+                    return false;
+                }
+            }
+        }
+        if (str.empty() || (globPattern.front() != '?' && globPattern.front() != str.front())) {
+            return false;
+        }
+        globPattern.remove_prefix(1);
+        str.remove_prefix(1);
+    }
+    return str.empty();
+}
+
+SettingsIndex::Map_t::const_iterator SettingsIndex::findEntry(std::string_view section, std::string_view settingName) const
+{
+    auto range = m_entries.equal_range(SplitKey {section, settingName});
+    for (auto entryIt = range.first; entryIt != range.second; ++entryIt) {
+        if (entryIt->second.section == section) {
+            return entryIt;
+        }
+    }
+    return m_entries.end();
+}
+
+SettingsIndex::Map_t::const_iterator SettingsIndex::prefixEnd(std::string_view prefix) const
+{
+    // First key greater than all keys starting with prefix
+    std::string upperBound(prefix);
+    while (!upperBound.empty() && static_cast<unsigned char>(upperBound.back()) == 0xFF) {
+        upperBound.pop_back();
+    }
+    if (upperBound.empty()) {
+        return m_entries.end();
+    }
+    upperBound.back() = static_cast<char>(static_cast<unsigned char>(upperBound.back()) + 1);
+    return m_entries.lower_bound(upperBound);
+}
+
+} // namespace Common
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "appsetting.hpp"
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Common {
+
+/**
+ * @brief The SettingsIndex class Sorted index of settings by full key "<section>.<name>"
+ * @note Used by @ref ApplicationSettings for lookups, prefix and glob queries and ordered iteration
+ */
+class SettingsIndex
+{
+public:
+    struct Entry
+    {
+        std::string                 section;
+        std::shared_ptr<AppSetting> pSetting;
+    };
+
+    // Full key "<section>.<name>" is compared with (section, name) pair without building string
+    struct SplitKey
+    {
+        std::string_view section;
+        std::string_view name;
+    };
+    struct KeyLess
+    {
+        using is_transparent = void;
+        bool operator()(const std::string& a, const std::string& b) const;
+        bool operator()(const std::string& a, const SplitKey& b) const;
+        bool operator()(const SplitKey& a, const std::string& b) const;
+    };
+
+    // Different (section, name) pairs may produce the same full key, e.g. "a.b"+"c" and "a"+"b.c"
+    using Map_t = std::multimap<std::string, Entry, KeyLess>;
+
+    class Range;
+
+    /**
+     * @brief The Iterator class Forward iterator over entries, matching query of range
+     */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Map_t::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        Iterator() = default;
+
+        reference operator*() const { return *m_it; }
+        pointer operator->() const { return &(*m_it); }
+
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const { return m_it == other.m_it; }
+        bool operator!=(const Iterator& other) const { return m_it != other.m_it; }
+
+    private:
+        friend class Range;
+        Iterator(const Range* pRange, Map_t::const_iterator it);
+
+        const Range*            m_pRange {nullptr};
+        Map_t::const_iterator   m_it;
+
+        void skipNotMatching();
+    };
+
+    /**
+     * @brief The Range class Lazy range of index entries. Entries are filtered while iterating
+     * @note Range is invalidated by any change of index
+     */
+    class Range
+    {
+    public:
+        Iterator begin() const;
+        Iterator end() const;
+        bool empty() const;
+
+    private:
+        friend class SettingsIndex;
+        friend class Iterator;
+        Range(Map_t::const_iterator first, Map_t::const_iterator last, std::string globPattern);
+
+        Map_t::const_iterator   m_first;
+        Map_t::const_iterator   m_last;
+        std::string             m_globPattern; // Empty if all entries of range match
+    };
+
+    void insert(const std::string& section, const std::string& settingName, const std::shared_ptr<AppSetting>& pSetting);
+    bool erase(std::string_view section, std::string_view settingName);
+    void clear();
+
+    std::shared_ptr<AppSetting> find(std::string_view section, std::string_view settingName) const;
+    std::size_t size() const;
+
+    /**
+     * @brief all   Get all entries, ordered by full key
+     */
+    Range all() const;
+
+    /**
+     * @brief findPrefix    Get entries which full key starts with prefix
+     * @param prefix        For example "plugins." for all settings of "plugins" section
+     */
+    Range findPrefix(std::string_view prefix) const;
+
+    /**
+     * @brief findMatching  Get entries which full key matches glob pattern
+     * @param globPattern   '*' matches any characters except '.', "**" matches any characters, '?' matches one character.
+     *                      For example "cache.*.size"
+     */
+    Range findMatching(std::string_view globPattern) const;
+
+    /**
+     * @brief isGlobMatch   Check if string matches glob pattern (see @ref findMatching)
+     */
+    static bool isGlobMatch(std::string_view str, std::string_view globPattern);
+
+private:
+    Map_t m_entries;
+
+    Map_t::const_iterator findEntry(std::string_view section, std::string_view settingName) const;
+    Map_t::const_iterator prefixEnd(std::string_view prefix) const;
+};
+
+} // namespace Common
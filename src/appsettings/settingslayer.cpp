@@ -0,0 +1,81 @@
+#include "settingslayer.hpp"
+
+namespace Common {
+
+SettingsLayer::SettingsLayer(const std::string &name) :
+    m_name {name}
+{
+
+}
+
+std::string_view SettingsLayer::getName() const
+{
+    return m_name;
+}
+
+std::shared_ptr<AppSetting> SettingsLayer::setValue(const std::string &section, const std::string &settingName, const AppSettingValue_t &v)
+{
+    auto& pSett = m_settings[section][settingName];
+    if (!pSett) {
+        pSett = std::make_shared<AppSetting>();
+        pSett->setName(settingName);
+    }
+    pSett->setValue(v);
+    return pSett;
+}
+
+std::shared_ptr<AppSetting> SettingsLayer::setRawValue(const std::string &section, const std::string &settingName, const std::string &rawValue)
+{
+    auto& pSett = m_settings[section][settingName];
+    if (!pSett) {
+        pSett = std::make_shared<AppSetting>();
+        pSett->setName(settingName);
+    }
+    pSett->setRawValue(rawValue);
+    return pSett;
+}
+
+std::shared_ptr<AppSetting> SettingsLayer::getSetting(std::string_view section, std::string_view settingName) const
+{
+    auto sectionIt = m_settings.find(section);
+    if (sectionIt == m_settings.end()) {
+        return {};
+    }
+    auto settIt = sectionIt->second.find(settingName);
+    if (settIt == sectionIt->second.end()) {
+        return {};
+    }
+    return settIt->second;
+}
+
+bool SettingsLayer::removeSetting(std::string_view section, std::string_view settingName)
+{
+    auto sectionIt = m_settings.find(section);
+    if (sectionIt == m_settings.end()) {
+        return false;
+    }
+    auto settIt = sectionIt->second.find(settingName);
+    if (settIt == sectionIt->second.end()) {
+        return false;
+    }
+    sectionIt->second.erase(settIt);
+    if (sectionIt->second.empty()) {
+        m_settings.erase(sectionIt);
+    }
+    return true;
+}
+
+SettingsLayer::SettingsMap_t SettingsLayer::replaceSettings(SettingsMap_t &&settings)
+{
+    SettingsMap_t res;
+    res.swap(m_settings);
+    m_settings = std::move(settings);
+    return res;
+}
+
+const SettingsLayer::SettingsMap_t &SettingsLayer::getSettings() const
+{
+    return m_settings;
+}
+
+} // namespace Common
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "appsetting.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace Common {
+
+/**
+ * @brief The SettingsLayer class One level of layered configuration (host overrides, environment, arguments, etc.)
+ * @note Layers are owned by @ref ApplicationSettings, which keeps the resolved overlay index in sync
+ */
+class SettingsLayer
+{
+public:
+    using SettingsMap_t = std::map<std::string, std::map<std::string, std::shared_ptr<AppSetting>, std::less<> >, std::less<> >;
+
+    explicit SettingsLayer(const std::string& name);
+
+    std::string_view getName() const;
+
+    /**
+     * @brief setValue      Set value in layer, creating setting if not exist
+     * @param section       Section of setting
+     * @param settingName   Name of setting
+     * @param v             Value to set
+     * @return              Setting, stored in layer
+     */
+    std::shared_ptr<AppSetting> setValue(const std::string& section, const std::string& settingName, const AppSettingValue_t& v);
+    std::shared_ptr<AppSetting> setRawValue(const std::string& section, const std::string& settingName, const std::string& rawValue);
+    std::shared_ptr<AppSetting> getSetting(std::string_view section, std::string_view settingName) const;
+    bool removeSetting(std::string_view section, std::string_view settingName);
+
+    /**
+     * @brief replaceSettings   Replace all settings of layer
+     * @param settings          New contents of layer
+     * @return                  Previous contents of layer
+     */
+    SettingsMap_t replaceSettings(SettingsMap_t&& settings);
+    const SettingsMap_t& getSettings() const;
+
+private:
+    std::string     m_name;
+    SettingsMap_t   m_settings;
+};
+
+} // namespace Common
@@ -0,0 +1,243 @@
+#include "settingsnotifier.hpp"
+
+#include "settingsindex.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+
+namespace Common {
+
+namespace {
+
+struct PendingBatch
+{
+    const SettingsNotifier*     pOwner;
+    int                         depth;
+    std::vector<SettingChange>  changes;
+};
+thread_local std::vector<PendingBatch> pendingBatches;
+
+PendingBatch* findPendingBatch(const SettingsNotifier* pOwner) {
+    for (auto& batch : pendingBatches) {
+        if (batch.pOwner == pOwner) {
+            return &batch;
+        }
+    }
+    return nullptr;
+}
+
+void invokeCallback(const SettingsNotifier::Callback_t& callback, const std::vector<SettingChange>& changes) {
+    try {
+        callback(changes);
+    } catch (std::exception& ex) {
+        COMPLOG_ERROR("Settings change subscriber thrown exception:", ex.what());
+    } catch (...) {
+        COMPLOG_ERROR("Settings change subscriber thrown unknown exception");
+    }
+}
+
+} // namespace
+
+
+SettingsNotifier::Batch::Batch(SettingsNotifier &notifier) :
+    m_notifier {notifier}
+{
+    m_notifier.beginBatch();
+}
+
+SettingsNotifier::Batch::~Batch()
+{
+    m_notifier.endBatch();
+}
+
+
+SettingsNotifier::SettingsNotifier() :
+    m_pSubscribers {std::make_shared<const SubscribersList_t>()}
+{
+
+}
+
+SettingsNotifier::~SettingsNotifier()
+{
+    if (!m_dispatcherThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_dispatcherMx);
+        m_isStopping = true;
+    }
+    m_dispatcherCv.notify_one();
+    m_dispatcherThread.join();
+}
+
+SettingsNotifier::SubscriptionId_t SettingsNotifier::subscribe(const std::string &pattern, Callback_t &&callback, DeliveryMode mode)
+{
+    auto pSubscriber = std::make_shared<Subscriber>();
+    pSubscriber->pattern = pattern;
+    pSubscriber->callback = std::move(callback);
+    pSubscriber->mode = mode;
+
+    std::lock_guard lock(m_subscribeMx);
+    pSubscriber->id = ++m_lastSubscriptionId;
+    if (mode == DeliveryMode::Queued && !m_dispatcherThread.joinable()) {
+        startDispatcher();
+    }
+
+    auto pNewList = std::make_shared<SubscribersList_t>(*std::atomic_load(&m_pSubscribers));
+    pNewList->push_back(pSubscriber);
+    m_subscribersCount.store(pNewList->size(), std::memory_order_relaxed);
+    std::atomic_store(&m_pSubscribers, std::shared_ptr<const SubscribersList_t>(std::move(pNewList)));
+    return pSubscriber->id;
+}
+
+void SettingsNotifier::unsubscribe(SubscriptionId_t subscriptionId)
+{
+    std::lock_guard lock(m_subscribeMx);
+    auto pNewList = std::make_shared<SubscribersList_t>(*std::atomic_load(&m_pSubscribers));
+    auto subscriberIt = std::find_if(pNewList->begin(), pNewList->end(), [subscriptionId](const auto& pSubscriber) {
+        return pSubscriber->id == subscriptionId;
+    });
+    if (subscriberIt == pNewList->end()) {
+        return;
+    }
+
+    // Queued deliveries still hold subscriber, so it must be marked to skip them
+    (*subscriberIt)->isActive.store(false, std::memory_order_relaxed);
+    pNewList->erase(subscriberIt);
+    m_subscribersCount.store(pNewList->size(), std::memory_order_relaxed);
+    std::atomic_store(&m_pSubscribers, std::shared_ptr<const SubscribersList_t>(std::move(pNewList)));
+}
+
+void SettingsNotifier::notify(const std::string &section, std::string_view settingName, const AppSettingValue_t &value)
+{
+    if (!hasSubscribers()) {
+        return;
+    }
+
+    if (auto pBatch = findPendingBatch(this); pBatch) {
+        pBatch->changes.push_back({section, std::string(settingName), value});
+        return;
+    }
+    deliver({{section, std::string(settingName), value}});
+}
+
+void SettingsNotifier::beginBatch()
+{
+    if (auto pBatch = findPendingBatch(this); pBatch) {
+        ++pBatch->depth;
+        return;
+    }
+    pendingBatches.push_back({this, 1, {}});
+}
+
+void SettingsNotifier::endBatch()
+{
+    auto batchIt = std::find_if(pendingBatches.begin(), pendingBatches.end(), [this](const PendingBatch& batch) {
+        return batch.pOwner == this;
+    });
+    if (batchIt == pendingBatches.end() || --batchIt->depth > 0) {
+        return;
+    }
+
+    auto changes = std::move(batchIt->changes);
+    pendingBatches.erase(batchIt);
+    if (!changes.empty()) {
+        deliver(std::move(changes));
+    }
+}
+
+std::size_t SettingsNotifier::getBatchSize() const
+{
+    auto pBatch = findPendingBatch(this);
+    return (pBatch ? pBatch->changes.size() : 0);
+}
+
+void SettingsNotifier::dropBatchChanges(std::size_t size)
+{
+    if (auto pBatch = findPendingBatch(this); pBatch && pBatch->changes.size() > size) {
+        pBatch->changes.resize(size);
+    }
+}
+
+void SettingsNotifier::waitDelivered()
+{
+    auto targetCount = m_queuedCount.load(std::memory_order_acquire);
+    std::unique_lock lock(m_dispatcherMx);
+    m_deliveredCv.wait(lock, [this, targetCount]() {
+        return m_deliveredCount.load(std::memory_order_acquire) >= targetCount;
+    });
+}
+
+void SettingsNotifier::deliver(std::vector<SettingChange> &&changes)
+{
+    auto pSubscribers = std::atomic_load(&m_pSubscribers);
+
+    std::vector<std::string> fullKeys;
+    fullKeys.reserve(changes.size());
+    for (auto& change : changes) {
+        fullKeys.push_back(change.section + "." + change.name);
+    }
+
+    for (auto& pSubscriber : *pSubscribers) {
+        std::vector<SettingChange> matchingChanges;
+        for (std::size_t i = 0; i < changes.size(); ++i) {
+            if (SettingsIndex::isGlobMatch(fullKeys[i], pSubscriber->pattern)) {
+                matchingChanges.push_back(changes[i]);
+            }
+        }
+        if (matchingChanges.empty()) {
+            continue;
+        }
+
+        if (pSubscriber->mode == DeliveryMode::Synchronous) {
+            invokeCallback(pSubscriber->callback, matchingChanges);
+            continue;
+        }
+        m_queuedCount.fetch_add(1, std::memory_order_acq_rel);
+        m_deliveryQueue.push({pSubscriber, std::move(matchingChanges)});
+        wakeDispatcher();
+    }
+}
+
+void SettingsNotifier::startDispatcher()
+{
+    m_dispatcherThread = std::thread(&SettingsNotifier::dispatcherLoop, this);
+}
+
+void SettingsNotifier::dispatcherLoop()
+{
+    while (true) {
+        while (auto delivery = m_deliveryQueue.pop()) {
+            if (delivery->pSubscriber->isActive.load(std::memory_order_relaxed)) {
+                invokeCallback(delivery->pSubscriber->callback, delivery->changes);
+            }
+            m_deliveredCount.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        std::unique_lock lock(m_dispatcherMx);
+        m_deliveredCv.notify_all();
+
+        // Flag must be visible before queue is checked again, see wakeDispatcher()
+        m_isDispatcherWaiting.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_deliveryQueue.empty()) {
+            if (m_isStopping) {
+                break;
+            }
+            m_dispatcherCv.wait(lock);
+        }
+        m_isDispatcherWaiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+void SettingsNotifier::wakeDispatcher()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_isDispatcherWaiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard lock(m_dispatcherMx);
+        m_dispatcherCv.notify_one();
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "appsettingscommon.hpp"
+#include "../mpscqueue.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The SettingChange struct Single change of setting value
+ */
+struct SettingChange
+{
+    std::string         section;
+    std::string         name;
+    AppSettingValue_t   value;  // New effective value, std::monostate if setting was removed
+};
+
+/**
+ * @brief The SettingsNotifier class Delivers setting changes to subscribers
+ * @note Changes made inside batch (see @ref Batch) are delivered together when outermost batch of thread ends
+ */
+class SettingsNotifier : public boost::noncopyable
+{
+public:
+    using SubscriptionId_t = uint64_t;
+    using Callback_t = std::function<void(const std::vector<SettingChange>&)>;
+
+    enum class DeliveryMode
+    {
+        Synchronous,    // Callback is called in thread, which changed setting
+        Queued,         // Callback is called in dispatcher thread
+    };
+
+    /**
+     * @brief The Batch class RAII batch of changes for current thread
+     */
+    class Batch : public boost::noncopyable
+    {
+    public:
+        explicit Batch(SettingsNotifier& notifier);
+        ~Batch();
+
+    private:
+        SettingsNotifier& m_notifier;
+    };
+
+    SettingsNotifier();
+    ~SettingsNotifier();
+
+    /**
+     * @brief subscribe     Subscribe for changes
+     * @param pattern       Glob pattern of full key "<section>.<name>" (see @ref SettingsIndex::findMatching):
+     *                      "net.timeout" for one setting, "net.*" for section, "**" for all settings
+     * @param callback      Callback to receive changes, matching pattern
+     * @param mode          Delivery mode
+     * @return              Subscription id for @ref unsubscribe
+     */
+    SubscriptionId_t subscribe(const std::string& pattern, Callback_t&& callback, DeliveryMode mode = DeliveryMode::Synchronous);
+    void unsubscribe(SubscriptionId_t subscriptionId);
+
+    bool hasSubscribers() const {
+        return (m_subscribersCount.load(std::memory_order_relaxed) != 0);
+    }
+
+    /**
+     * @brief notify    Report change of setting
+     */
+    void notify(const std::string& section, std::string_view settingName, const AppSettingValue_t& value);
+
+    void beginBatch();
+    void endBatch();
+
+    /**
+     * @brief getBatchSize      Count of changes, collected by batch of current thread
+     */
+    std::size_t getBatchSize() const;
+
+    /**
+     * @brief dropBatchChanges  Forget changes of current thread batch, collected after batch had size
+     * @note Used to cancel notifications of changes, which were reverted before batch ends
+     */
+    void dropBatchChanges(std::size_t size);
+
+    /**
+     * @brief waitDelivered Wait until dispatcher thread delivers all queued changes
+     */
+    void waitDelivered();
+
+private:
+    struct Subscriber
+    {
+        SubscriptionId_t    id;
+        std::string         pattern;
+        Callback_t          callback;
+        DeliveryMode        mode;
+        std::atomic<bool>   isActive {true};
+    };
+    using SubscribersList_t = std::vector<std::shared_ptr<Subscriber> >;
+
+    struct Delivery
+    {
+        std::shared_ptr<Subscriber> pSubscriber;
+        std::vector<SettingChange>  changes;
+    };
+
+    std::mutex                                  m_subscribeMx;
+    std::shared_ptr<const SubscribersList_t>    m_pSubscribers;
+    std::atomic<std::size_t>                    m_subscribersCount {0};
+    SubscriptionId_t                            m_lastSubscriptionId {0};
+
+    // Dispatcher thread for queued delivery
+    MpscQueue<Delivery>         m_deliveryQueue;
+    std::thread                 m_dispatcherThread;
+    std::mutex                  m_dispatcherMx;
+    std::condition_variable     m_dispatcherCv;
+    std::condition_variable     m_deliveredCv;
+    std::atomic<bool>           m_isDispatcherWaiting {false};
+    std::atomic<uint64_t>       m_queuedCount {0};
+    std::atomic<uint64_t>       m_deliveredCount {0};
+    bool                        m_isStopping {false};
+
+    void deliver(std::vector<SettingChange>&& changes);
+    void startDispatcher();
+    void dispatcherLoop();
+    void wakeDispatcher();
+};
+
+} // namespace Common
@@ -0,0 +1,40 @@
+#include "settingstransaction.hpp"
+
+#include "applicationsettings.hpp"
+
+namespace Common {
+
+SettingsTransaction::SettingsTransaction(ApplicationSettings &settings) :
+    m_settings {settings}
+{
+
+}
+
+void SettingsTransaction::setValue(const std::string &section, const std::string &settingName, const AppSettingValue_t &v)
+{
+    m_stagedChanges[{section, settingName}] = v;
+}
+
+void SettingsTransaction::removeSetting(const std::string &section, const std::string &settingName)
+{
+    m_stagedChanges[{section, settingName}] = std::nullopt;
+}
+
+bool SettingsTransaction::commit()
+{
+    auto isCommitted = m_settings.commitTransaction(*this);
+    m_stagedChanges.clear();
+    return isCommitted;
+}
+
+void SettingsTransaction::abort()
+{
+    m_stagedChanges.clear();
+}
+
+bool SettingsTransaction::empty() const
+{
+    return m_stagedChanges.empty();
+}
+
+} // namespace Common
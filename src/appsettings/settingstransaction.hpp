@@ -0,0 +1,80 @@
+#pragma once
+
+#include "appsettingscommon.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Common {
+
+class ApplicationSettings;
+
+/**
+ * @brief The SettingVersionChange struct Change of one setting between versions
+ * @note std::nullopt means setting did not exist
+ */
+struct SettingVersionChange
+{
+    std::string                         section;
+    std::string                         name;
+    std::optional<AppSettingValue_t>    oldValue;
+    std::optional<AppSettingValue_t>    newValue;
+};
+
+/**
+ * @brief The SettingsVersion struct Version of settings, stores only changes from previous version
+ * @note Values, loaded from file and not accessed yet, are stored as source text and converted on diff
+ */
+struct SettingsVersion
+{
+    struct RecordedChange
+    {
+        SettingVersionChange    change;
+        bool                    isOldRaw {false};
+        bool                    isNewRaw {false};
+    };
+
+    uint64_t                    id;
+    std::vector<RecordedChange> changes;
+};
+
+/**
+ * @brief The SettingsTransaction class Group of changes, applied by @ref commit() at once
+ * @note Changes are staged in transaction and not visible until commit. Last change of key wins.
+ *       Transaction changes base settings, which are saved to config, and values are checked by their rules.
+ *       Value of key, overridden by layer, stays effective; removal of key, existing only in layers, changes nothing.
+ *       Commit is atomic only for readers, which hold @ref ApplicationSettings::lockShared() while reading:
+ *       values are changed in place one by one, so reader of single setting without lock may see
+ *       some changes of commit applied and others not yet. Subscribers get all changes of commit in one batch
+ */
+class SettingsTransaction
+{
+public:
+    explicit SettingsTransaction(ApplicationSettings& settings);
+
+    void setValue(const std::string& section, const std::string& settingName, const AppSettingValue_t& v);
+    void removeSetting(const std::string& section, const std::string& settingName);
+
+    /**
+     * @brief commit    Apply all changes and create new settings version
+     * @return          false if any value was rejected by setting. Nothing is applied and notified in this case
+     */
+    bool commit();
+
+    /**
+     * @brief abort Drop staged changes
+     */
+    void abort();
+    bool empty() const;
+
+private:
+    friend class ApplicationSettings;
+
+    ApplicationSettings& m_settings;
+    std::map<std::pair<std::string, std::string>, std::optional<AppSettingValue_t> > m_stagedChanges;
+};
+
+} // namespace Common
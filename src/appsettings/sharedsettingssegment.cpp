@@ -0,0 +1,538 @@
+#include "sharedsettingssegment.hpp"
+
+#include "applicationsettings.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC            {0x53545353}; // "SSTS"
+constexpr uint32_t SEGMENT_FORMAT_VERSION   {2};
+
+
+struct ImageHeader
+{
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t imageSize;
+};
+
+struct ImageEntry
+{
+    uint32_t sectionOffset;
+    uint32_t sectionLength;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t valueType;     // SharedValueView::Type
+    uint32_t reserved;
+    union {
+        int64_t intValue;
+        double  doubleValue;
+        struct {
+            uint32_t offset;
+            uint32_t length;    // Count of elements for arrays
+        } stringValue;
+    };
+};
+
+constexpr std::size_t alignUp(std::size_t v, std::size_t alignment) {
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief The ImageView class Bounds-checked access to settings image. Image may be torn if read during publish
+ */
+class ImageView
+{
+public:
+    ImageView(const char* pData, std::size_t capacity) :
+        m_pData {pData},
+        m_capacity {capacity}
+    {
+        if (m_capacity < sizeof(ImageHeader)) {
+            return;
+        }
+        ImageHeader header;
+        std::memcpy(&header, m_pData, sizeof(header));
+        if (sizeof(ImageHeader) + std::size_t(header.entryCount) * sizeof(ImageEntry) > m_capacity) {
+            return;
+        }
+        m_entryCount = header.entryCount;
+    }
+
+    uint32_t entryCount() const {
+        return m_entryCount;
+    }
+
+    ImageEntry entry(uint32_t index) const {
+        ImageEntry res;
+        std::memcpy(&res, m_pData + sizeof(ImageHeader) + index * sizeof(ImageEntry), sizeof(res));
+        return res;
+    }
+
+    std::string_view string(uint32_t offset, uint32_t length) const {
+        if (std::size_t(offset) + length > m_capacity) {
+            return {};
+        }
+        return {m_pData + offset, length};
+    }
+
+    const ImageEntry* find(std::string_view section, std::string_view settingName, ImageEntry& res) const {
+        uint32_t first = 0;
+        uint32_t last = m_entryCount;
+        while (first < last) {
+            auto middle = first + (last - first) / 2;
+            res = entry(middle);
+            auto cmp = std::make_tuple(string(res.sectionOffset, res.sectionLength), string(res.nameOffset, res.nameLength));
+            auto target = std::make_tuple(section, settingName);
+            if (cmp == target) {
+                return &res;
+            }
+            if (cmp < target) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    const char*     m_pData;
+    std::size_t     m_capacity;
+    uint32_t        m_entryCount {0};
+};
+
+struct SegmentHeader
+{
+    uint32_t                magic;
+    uint32_t                formatVersion;
+    uint64_t                slotCapacity;
+    std::atomic<uint64_t>   generation;         // Last published generation, slot is (generation & 1)
+    std::atomic<uint64_t>   writeGeneration;    // Generation being written now
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared segment requires address-free atomics");
+
+constexpr std::size_t SEGMENT_SLOTS_OFFSET {alignUp(sizeof(SegmentHeader), 64)};
+
+SegmentHeader* header(void* pMapping) {
+    return static_cast<SegmentHeader*>(pMapping);
+}
+
+} // namespace
+
+
+SharedSettingsSegment::SharedSettingsSegment()
+{
+
+}
+
+SharedSettingsSegment::~SharedSettingsSegment()
+{
+    close();
+}
+
+bool SharedSettingsSegment::create(const std::string &name, std::size_t slotCapacity)
+{
+    close();
+
+    m_fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        setError("shm_open failed: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    m_name = name;
+    m_isOwner = true;
+
+    slotCapacity = alignUp(std::max(slotCapacity, sizeof(ImageHeader)), 64);
+    m_mappingSize = SEGMENT_SLOTS_OFFSET + 2 * slotCapacity;
+    if (::ftruncate(m_fd, m_mappingSize) != 0) {
+        setError("ftruncate failed: " + std::string(std::strerror(errno)));
+        close();
+        return false;
+    }
+    if (!mapSegment(PROT_READ | PROT_WRITE)) {
+        close();
+        return false;
+    }
+
+    // Memory is zero-filled, so both slots already contain empty images
+    auto pHeader = new (m_pMapping) SegmentHeader;
+    pHeader->slotCapacity = slotCapacity;
+    pHeader->generation.store(0, std::memory_order_relaxed);
+    pHeader->writeGeneration.store(0, std::memory_order_relaxed);
+    pHeader->formatVersion = SEGMENT_FORMAT_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    pHeader->magic = SEGMENT_MAGIC;
+
+    COMPLOG_INFO("Shared settings segment created:", name);
+    return true;
+}
+
+bool SharedSettingsSegment::open(const std::string &name)
+{
+    close();
+
+    m_fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (m_fd < 0) {
+        setError("shm_open failed: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    m_name = name;
+
+    struct stat segmentStat;
+    if (::fstat(m_fd, &segmentStat) != 0 || std::size_t(segmentStat.st_size) < SEGMENT_SLOTS_OFFSET) {
+        setError("Invalid segment size");
+        close();
+        return false;
+    }
+    m_mappingSize = segmentStat.st_size;
+    if (!mapSegment(PROT_READ)) {
+        close();
+        return false;
+    }
+
+    auto pHeader = header(m_pMapping);
+    if (pHeader->magic != SEGMENT_MAGIC || pHeader->formatVersion != SEGMENT_FORMAT_VERSION ||
+        SEGMENT_SLOTS_OFFSET + 2 * pHeader->slotCapacity > m_mappingSize) {
+        setError("Invalid segment header");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SharedSettingsSegment::close()
+{
+    if (m_pMapping) {
+        ::munmap(m_pMapping, m_mappingSize);
+        m_pMapping = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_isOwner) {
+        ::shm_unlink(m_name.c_str());
+        m_isOwner = false;
+    }
+    m_mappingSize = 0;
+    m_name.clear();
+}
+
+bool SharedSettingsSegment::isOpen() const
+{
+    return (m_pMapping != nullptr);
+}
+
+bool SharedSettingsSegment::isOwner() const
+{
+    return m_isOwner;
+}
+
+bool SharedSettingsSegment::publish(const ApplicationSettings &settings)
+{
+    if (!isOpen() || !m_isOwner) {
+        setError("Segment is not created by this object");
+        return false;
+    }
+
+    struct PendingEntry {
+        std::string section;
+        std::string_view name;
+        const AppSettingValue_t* pValue;
+    };
+    std::vector<PendingEntry> pendingEntries;
+    settings.forEachSetting([&](const std::string& section, const std::shared_ptr<AppSetting>& pSett) {
+        pendingEntries.push_back({section, pSett->getName(), &pSett->getValueVariant()});
+    });
+    std::sort(pendingEntries.begin(), pendingEntries.end(), [](const PendingEntry& a, const PendingEntry& b) {
+        return std::tie(a.section, a.name) < std::tie(b.section, b.name);
+    });
+
+    // Build image: header, sorted entries, string pool. All offsets are relative to slot start
+    std::vector<char> image(sizeof(ImageHeader) + pendingEntries.size() * sizeof(ImageEntry));
+    auto appendString = [&image](std::string_view str) {
+        auto offset = static_cast<uint32_t>(image.size());
+        image.insert(image.end(), str.begin(), str.end());
+        return offset;
+    };
+    auto appendArray = [&image](const auto& values) {
+        using Element_t = typename std::decay_t<decltype(values)>::value_type;
+        image.resize(alignUp(image.size(), alignof(int64_t)));
+        auto offset = static_cast<uint32_t>(image.size());
+        image.resize(image.size() + values.size() * sizeof(Element_t));
+        if (!values.empty()) {
+            std::memcpy(image.data() + offset, values.data(), values.size() * sizeof(Element_t));
+        }
+        return offset;
+    };
+
+    std::string_view lastSection;
+    uint32_t lastSectionOffset {0};
+    for (std::size_t i = 0; i < pendingEntries.size(); ++i) {
+        auto& pending = pendingEntries[i];
+
+        ImageEntry entry {};
+        if (i == 0 || pending.section != lastSection) {
+            lastSection = pending.section;
+            lastSectionOffset = appendString(lastSection);
+        }
+        entry.sectionOffset = lastSectionOffset;
+        entry.sectionLength = static_cast<uint32_t>(pending.section.size());
+        entry.nameOffset = appendString(pending.name);
+        entry.nameLength = static_cast<uint32_t>(pending.name.size());
+
+        auto& value = *pending.pValue;
+        if (std::holds_alternative<int64_t>(value)) {
+            entry.valueType = SharedValueView::Int;
+            entry.intValue = std::get<int64_t>(value);
+        } else if (std::holds_alternative<double>(value)) {
+            entry.valueType = SharedValueView::Double;
+            entry.doubleValue = std::get<double>(value);
+        } else if (std::holds_alternative<std::string>(value)) {
+            auto& strValue = std::get<std::string>(value);
+            entry.valueType = SharedValueView::String;
+            entry.stringValue.offset = appendString(strValue);
+            entry.stringValue.length = static_cast<uint32_t>(strValue.size());
+        } else if (auto pInts = std::get_if<std::vector<int64_t> >(&value); pInts) {
+            entry.valueType = SharedValueView::IntArray;
+            entry.stringValue.offset = appendArray(*pInts);
+            entry.stringValue.length = static_cast<uint32_t>(pInts->size());
+        } else if (auto pDoubles = std::get_if<std::vector<double> >(&value); pDoubles) {
+            entry.valueType = SharedValueView::DoubleArray;
+            entry.stringValue.offset = appendArray(*pDoubles);
+            entry.stringValue.length = static_cast<uint32_t>(pDoubles->size());
+        } else if (auto pStrings = std::get_if<std::vector<std::string> >(&value); pStrings) {
+            std::vector<uint32_t> elementBounds;
+            elementBounds.reserve(pStrings->size() * 2);
+            for (auto& element : *pStrings) {
+                elementBounds.push_back(appendString(element));
+                elementBounds.push_back(static_cast<uint32_t>(element.size()));
+            }
+            entry.valueType = SharedValueView::StringList;
+            entry.stringValue.offset = appendArray(elementBounds);
+            entry.stringValue.length = static_cast<uint32_t>(pStrings->size());
+        } else {
+            entry.valueType = SharedValueView::Empty;
+        }
+        std::memcpy(image.data() + sizeof(ImageHeader) + i * sizeof(ImageEntry), &entry, sizeof(entry));
+    }
+
+    ImageHeader imageHeader {};
+    imageHeader.entryCount = static_cast<uint32_t>(pendingEntries.size());
+    imageHeader.imageSize = image.size();
+    std::memcpy(image.data(), &imageHeader, sizeof(imageHeader));
+
+    auto pHeader = header(m_pMapping);
+    if (image.size() > pHeader->slotCapacity) {
+        setError("Settings image does not fit into segment: " + std::to_string(image.size()) + " bytes");
+        return false;
+    }
+
+    std::lock_guard lock(m_publishMx);
+    auto nextGeneration = pHeader->generation.load(std::memory_order_relaxed) + 1;
+    pHeader->writeGeneration.store(nextGeneration, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(slotData(nextGeneration), image.data(), image.size());
+    pHeader->generation.store(nextGeneration, std::memory_order_release);
+    return true;
+}
+
+uint64_t SharedSettingsSegment::getGeneration() const
+{
+    if (!isOpen()) {
+        return 0;
+    }
+    return header(m_pMapping)->generation.load(std::memory_order_acquire);
+}
+
+AppSettingValue_t SharedSettingsSegment::getValue(std::string_view section, std::string_view settingName) const
+{
+    return readValue(section, settingName, [](const SharedValueView& view) {
+        return view.toValue();
+    });
+}
+
+bool SharedSettingsSegment::hasSetting(std::string_view section, std::string_view settingName) const
+{
+    return readValue(section, settingName, [](const SharedValueView& view) {
+        return (view.getType() != SharedValueView::Empty);
+    });
+}
+
+std::size_t SharedSettingsSegment::getSettingsCount() const
+{
+    if (!isOpen()) {
+        return 0;
+    }
+
+    while (true) {
+        auto generation = beginRead();
+        auto res = ImageView(slotData(generation), header(m_pMapping)->slotCapacity).entryCount();
+        if (isReadValid(generation)) {
+            return res;
+        }
+    }
+}
+
+std::string SharedSettingsSegment::getLastErrorText() const
+{
+    return m_lastError;
+}
+
+uint64_t SharedSettingsSegment::beginRead() const
+{
+    return header(m_pMapping)->generation.load(std::memory_order_acquire);
+}
+
+bool SharedSettingsSegment::isReadValid(uint64_t generation) const
+{
+    // Slot is overwritten only by generation + 2, so data is valid if it was not started yet
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (header(m_pMapping)->writeGeneration.load(std::memory_order_relaxed) < generation + 2);
+}
+
+SharedValueView SharedSettingsSegment::findValue(uint64_t generation, std::string_view section, std::string_view settingName) const
+{
+    SharedValueView res;
+    res.m_pSlot = slotData(generation);
+    res.m_slotCapacity = header(m_pMapping)->slotCapacity;
+
+    ImageEntry entry;
+    if (!ImageView(res.m_pSlot, res.m_slotCapacity).find(section, settingName, entry) || entry.valueType > SharedValueView::StringList) {
+        return res;
+    }
+    res.m_type = static_cast<SharedValueView::Type>(entry.valueType);
+    res.m_intValue = entry.intValue;
+    res.m_doubleValue = entry.doubleValue;
+    res.m_offset = entry.stringValue.offset;
+    res.m_length = entry.stringValue.length;
+    return res;
+}
+
+const char *SharedSettingsSegment::slotData(uint64_t generation) const
+{
+    return static_cast<const char*>(m_pMapping) + SEGMENT_SLOTS_OFFSET + (generation & 1) * header(m_pMapping)->slotCapacity;
+}
+
+char *SharedSettingsSegment::slotData(uint64_t generation)
+{
+    return static_cast<char*>(m_pMapping) + SEGMENT_SLOTS_OFFSET + (generation & 1) * header(m_pMapping)->slotCapacity;
+}
+
+bool SharedSettingsSegment::mapSegment(int prot)
+{
+    auto pMapping = ::mmap(nullptr, m_mappingSize, prot, MAP_SHARED, m_fd, 0);
+    if (pMapping == MAP_FAILED) {
+        setError("mmap failed: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    m_pMapping = pMapping;
+    return true;
+}
+
+void SharedSettingsSegment::setError(const std::string &text)
+{
+    m_lastError = text;
+    COMPLOG_ERROR("Shared settings segment", m_name, ":", text);
+}
+
+
+template <typename T>
+ArrayView_t<T> SharedValueView::getArray(std::size_t count) const
+{
+    if (std::size_t(m_offset) + count * sizeof(T) > m_slotCapacity || m_offset % alignof(T) != 0) {
+        return {};
+    }
+    return ArrayView_t<T>(reinterpret_cast<const T*>(m_pSlot + m_offset), count);
+}
+
+SharedValueView::Type SharedValueView::getType() const
+{
+    return m_type;
+}
+
+int64_t SharedValueView::getInt() const
+{
+    return (m_type == Int ? m_intValue : 0);
+}
+
+double SharedValueView::getDouble() const
+{
+    return (m_type == Double ? m_doubleValue : 0.0);
+}
+
+std::string_view SharedValueView::getString() const
+{
+    if (m_type != String) {
+        return {};
+    }
+    return ImageView(m_pSlot, m_slotCapacity).string(m_offset, m_length);
+}
+
+ArrayView_t<int64_t> SharedValueView::getIntArray() const
+{
+    return (m_type == IntArray ? getArray<int64_t>(m_length) : ArrayView_t<int64_t>());
+}
+
+ArrayView_t<double> SharedValueView::getDoubleArray() const
+{
+    return (m_type == DoubleArray ? getArray<double>(m_length) : ArrayView_t<double>());
+}
+
+std::size_t SharedValueView::getStringListSize() const
+{
+    return (m_type == StringList ? getArray<uint32_t>(std::size_t(m_length) * 2).size() / 2 : 0);
+}
+
+std::string_view SharedValueView::getStringListElement(std::size_t index) const
+{
+    // Table of (offset, length) pairs of elements
+    auto elementBounds = (m_type == StringList ? getArray<uint32_t>(std::size_t(m_length) * 2) : ArrayView_t<uint32_t>());
+    if (2 * index + 1 >= elementBounds.size()) {
+        return {};
+    }
+    return ImageView(m_pSlot, m_slotCapacity).string(elementBounds[2 * index], elementBounds[2 * index + 1]);
+}
+
+AppSettingValue_t SharedValueView::toValue() const
+{
+    switch (m_type) {
+    case Int:           return m_intValue;
+    case Double:        return m_doubleValue;
+    case String:        return std::string(getString());
+    case IntArray: {
+        auto values = getIntArray();
+        return std::vector<int64_t>(values.begin(), values.end());
+    }
+    case DoubleArray: {
+        auto values = getDoubleArray();
+        return std::vector<double>(values.begin(), values.end());
+    }
+    case StringList: {
+        std::vector<std::string> res(getStringListSize());
+        for (std::size_t i = 0; i < res.size(); ++i) {
+            res[i] = getStringListElement(i);
+        }
+        return res;
+    }
+    default:            return {};
+    }
+}
+
+} // namespace Common
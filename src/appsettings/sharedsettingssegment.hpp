@@ -0,0 +1,166 @@
+#pragma once
+
+#include "appsettingscommon.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Common {
+
+class ApplicationSettings;
+
+/**
+ * @brief The SharedValueView class Value of setting in place in shared segment, nothing is copied
+ * @note Valid only inside reader of @ref SharedSettingsSegment::readValue: slot may be overwritten later.
+ *       Offsets are checked against slot bounds, so torn data gives wrong values, but never wrong memory access
+ */
+class SharedValueView
+{
+public:
+    enum Type : uint32_t
+    {
+        Empty = 0,
+        String,
+        Int,
+        Double,
+        IntArray,
+        DoubleArray,
+        StringList,
+    };
+
+    Type getType() const;
+    int64_t getInt() const;
+    double getDouble() const;
+    std::string_view getString() const;
+    ArrayView_t<int64_t> getIntArray() const;
+    ArrayView_t<double> getDoubleArray() const;
+    std::size_t getStringListSize() const;
+    std::string_view getStringListElement(std::size_t index) const;
+
+    /**
+     * @brief toValue   Copy value out of segment
+     */
+    AppSettingValue_t toValue() const;
+
+private:
+    friend class SharedSettingsSegment;
+
+    const char*     m_pSlot {nullptr};
+    std::size_t     m_slotCapacity {0};
+    Type            m_type {Empty};
+    int64_t         m_intValue {0};
+    double          m_doubleValue {0.0};
+    uint32_t        m_offset {0};
+    uint32_t        m_length {0};       // Count of elements for arrays
+
+    template <typename T>
+    ArrayView_t<T> getArray(std::size_t count) const;
+};
+
+/**
+ * @brief The SharedSettingsSegment class Read-only settings image in POSIX shared memory
+ * @note One process creates segment and publishes settings, other processes open it and read values in place.
+ *       Image contains only offsets, so it can be mapped at any address. Two slots are used: publisher writes
+ *       inactive slot and then switches generation, readers retry if slot was overwritten during read.
+ *       Only one publisher per segment is supported.
+ */
+class SharedSettingsSegment : public boost::noncopyable
+{
+public:
+    SharedSettingsSegment();
+    ~SharedSettingsSegment();
+
+    /**
+     * @brief create        Create segment for publishing (owner). Segment is unlinked on destruction
+     * @param name          Shared memory object name, for example "/myapp-settings"
+     * @param slotCapacity  Max size of one settings image, bytes
+     * @return              true if no error
+     */
+    bool create(const std::string& name, std::size_t slotCapacity = 1024 * 1024);
+
+    /**
+     * @brief open  Map existing segment for reading
+     * @param name  Shared memory object name
+     * @return      true if no error
+     */
+    bool open(const std::string& name);
+    void close();
+
+    bool isOpen() const;
+    bool isOwner() const;
+
+    /**
+     * @brief publish   Write effective settings into segment and switch readers to new generation
+     * @param settings  Settings to publish
+     * @return          false if segment is not owned or image does not fit into slot
+     */
+    bool publish(const ApplicationSettings& settings);
+
+    /**
+     * @brief getGeneration Get number of last publish. Changes every time settings are published
+     * @return              0 if nothing published yet
+     */
+    uint64_t getGeneration() const;
+
+    /**
+     * @brief readValue     Read value of setting in place
+     * @param reader        Called with view of value, type is SharedValueView::Empty if setting not exist.
+     *                      Called again if slot was overwritten during read, so it must not have other effects
+     *                      than its result
+     * @return              Result of reader, which has read consistent value
+     */
+    template <typename Reader_t>
+    auto readValue(std::string_view section, std::string_view settingName, Reader_t&& reader) const {
+        if (!isOpen()) {
+            return reader(SharedValueView());
+        }
+        while (true) {
+            auto generation = beginRead();
+            if constexpr (std::is_void_v<std::invoke_result_t<Reader_t&, const SharedValueView&> >) {
+                reader(findValue(generation, section, settingName));
+                if (isReadValid(generation)) {
+                    return;
+                }
+            } else {
+                auto res = reader(findValue(generation, section, settingName));
+                if (isReadValid(generation)) {
+                    return res;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief getValue      Read copy of value of setting from segment
+     * @return              std::monostate if setting not exist
+     */
+    AppSettingValue_t getValue(std::string_view section, std::string_view settingName) const;
+    bool hasSetting(std::string_view section, std::string_view settingName) const;
+    std::size_t getSettingsCount() const;
+
+    std::string getLastErrorText() const;
+
+private:
+    std::string     m_name;
+    int             m_fd {-1};
+    void*           m_pMapping {nullptr};
+    std::size_t     m_mappingSize {0};
+    bool            m_isOwner {false};
+    std::string     m_lastError;
+    std::mutex      m_publishMx;
+
+    uint64_t beginRead() const;
+    bool isReadValid(uint64_t generation) const;
+    SharedValueView findValue(uint64_t generation, std::string_view section, std::string_view settingName) const;
+
+    const char* slotData(uint64_t generation) const;
+    char* slotData(uint64_t generation);
+    bool mapSegment(int prot);
+    void setError(const std::string& text);
+};
+
+} // namespace Common
@@ -0,0 +1,198 @@
+#include "atomicfilewriter.hpp"
+
+#include "directorymanager.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+/**
+ * @brief The FdGuard class Closes descriptor on scope exit
+ */
+class FdGuard
+{
+public:
+    explicit FdGuard(int fd) : m_fd {fd} {}
+    ~FdGuard() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+    int get() const {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+bool writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(written);
+    }
+    return true;
+}
+
+} // namespace
+
+
+AtomicFileWriter &AtomicFileWriter::getInstance()
+{
+    static AtomicFileWriter inst;
+    return inst;
+}
+
+bool AtomicFileWriter::writeFile(int dtype, const std::filesystem::path &relPath, std::string_view data, Durability durability)
+{
+    auto dirFd = DirectoryManager::getInstance().getDirectoryFd(dtype);
+    if (dirFd < 0) {
+        COMPLOG_ERROR("AtomicFileWriter: directory is not available, type:", dtype, std::strerror(errno));
+        return false;
+    }
+    if (!relPath.has_parent_path()) {
+        return writeAt(dirFd, relPath.filename().string(), data, durability);
+    }
+
+    FdGuard parentFd(::openat(dirFd, relPath.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (parentFd.get() < 0) {
+        COMPLOG_ERROR("AtomicFileWriter: failed to open directory:", relPath.parent_path().string(), std::strerror(errno));
+        return false;
+    }
+    return writeAt(parentFd.get(), relPath.filename().string(), data, durability);
+}
+
+bool AtomicFileWriter::writeFile(const std::filesystem::path &filePath, std::string_view data, Durability durability)
+{
+    auto parentPath = filePath.parent_path();
+    FdGuard parentFd(::open(parentPath.empty() ? "." : parentPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (parentFd.get() < 0) {
+        COMPLOG_ERROR("AtomicFileWriter: failed to open directory:", parentPath.string(), std::strerror(errno));
+        return false;
+    }
+    return writeAt(parentFd.get(), filePath.filename().string(), data, durability);
+}
+
+uint64_t AtomicFileWriter::getDirectorySyncCount() const
+{
+    return m_directorySyncCount.load(std::memory_order_relaxed);
+}
+
+bool AtomicFileWriter::writeAt(int dirFd, const std::string &fileName, std::string_view data, Durability durability)
+{
+    std::string tempName;
+    FdGuard fileFd(createTempFile(dirFd, fileName, tempName));
+    if (fileFd.get() < 0) {
+        COMPLOG_ERROR("AtomicFileWriter: failed to create file:", fileName, std::strerror(errno));
+        return false;
+    }
+
+    auto removeTemp = [dirFd, &tempName]() {
+        if (!tempName.empty()) {
+            ::unlinkat(dirFd, tempName.c_str(), 0);
+        }
+    };
+    if (!writeAll(fileFd.get(), data) || (durability != Durability::None && ::fdatasync(fileFd.get()) != 0)) {
+        COMPLOG_ERROR("AtomicFileWriter: failed to write file:", fileName, std::strerror(errno));
+        removeTemp();
+        return false;
+    }
+
+    if (tempName.empty()) {
+        // Unnamed file: link directly if target does not exist, otherwise link under temporary name and rename
+        auto procPath = "/proc/self/fd/" + std::to_string(fileFd.get());
+        if (::linkat(AT_FDCWD, procPath.c_str(), dirFd, fileName.c_str(), AT_SYMLINK_FOLLOW) == 0) {
+            return (durability != Durability::Full || syncDirectory(dirFd));
+        }
+        tempName = "." + fileName + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(++m_tempCounter);
+        if (errno != EEXIST || ::linkat(AT_FDCWD, procPath.c_str(), dirFd, tempName.c_str(), AT_SYMLINK_FOLLOW) != 0) {
+            COMPLOG_ERROR("AtomicFileWriter: failed to link file:", fileName, std::strerror(errno));
+            return false;
+        }
+    }
+
+    if (::renameat(dirFd, tempName.c_str(), dirFd, fileName.c_str()) != 0) {
+        COMPLOG_ERROR("AtomicFileWriter: failed to replace file:", fileName, std::strerror(errno));
+        removeTemp();
+        return false;
+    }
+    return (durability != Durability::Full || syncDirectory(dirFd));
+}
+
+int AtomicFileWriter::createTempFile(int dirFd, const std::string &fileName, std::string &tempName)
+{
+    tempName.clear();
+#ifdef O_TMPFILE
+    auto fd = ::openat(dirFd, ".", O_TMPFILE | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        return fd;
+    }
+    if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL) {
+        return -1;
+    }
+#endif
+    tempName = "." + fileName + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(++m_tempCounter);
+    return ::openat(dirFd, tempName.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0644);
+}
+
+bool AtomicFileWriter::syncDirectory(int dirFd)
+{
+    struct stat dirStat;
+    if (::fstat(dirFd, &dirStat) != 0) {
+        return false;
+    }
+
+    DirectorySync* pSync {nullptr};
+    {
+        std::lock_guard lock(m_syncsMx);
+        auto& pDirSync = m_directorySyncs[{dirStat.st_dev, dirStat.st_ino}];
+        if (!pDirSync) {
+            pDirSync = std::make_unique<DirectorySync>();
+        }
+        pSync = pDirSync.get();
+    }
+
+    // Group commit: sync, started after this request, covers it. One writer syncs for all waiting ones
+    std::unique_lock lock(pSync->mx);
+    auto ticket = ++pSync->requested;
+    bool isOk {true};
+    while (pSync->completed < ticket) {
+        if (pSync->isSyncing) {
+            pSync->cv.wait(lock);
+            continue;
+        }
+        pSync->isSyncing = true;
+        auto target = pSync->requested;
+        lock.unlock();
+        isOk = (::fsync(dirFd) == 0);
+        m_directorySyncCount.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+        pSync->isSyncing = false;
+        if (isOk) {
+            pSync->completed = target;
+        }
+        pSync->cv.notify_all();
+        if (!isOk) {
+            COMPLOG_ERROR("AtomicFileWriter: failed to sync directory:", std::strerror(errno));
+            return false;
+        }
+    }
+    return isOk;
+}
+
+} // namespace Common
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#include <sys/types.h>
+
+namespace Common {
+
+/**
+ * @brief The Durability enum What must survive crash or power loss after write returns
+ */
+enum class Durability
+{
+    None,   // Replace is atomic for readers, but nothing is synced
+    Data,   // File data is synced before replace, so file is never seen partial. Replace itself may be lost
+    Full,   // Data and directory entry are synced. Directory sync is shared by concurrent writers
+};
+
+/**
+ * @brief The AtomicFileWriter class Replaces files atomically: readers see either old or new content
+ * @note File is written as unnamed O_TMPFILE and linked into directory when complete.
+ *       If filesystem does not support it, hidden temporary file is used, which may be left after crash
+ */
+class AtomicFileWriter : public boost::noncopyable
+{
+public:
+    static AtomicFileWriter& getInstance();
+
+    /**
+     * @brief writeFile     Atomically replace file in directory, registered in @ref DirectoryManager
+     * @param dtype         @ref DirectoryType enum or custom value
+     * @param relPath       Path relative to directory. Parent directories must exist
+     * @param data          New content of file
+     * @param durability    Sync level
+     * @return              true if file was replaced
+     */
+    bool writeFile(int dtype, const std::filesystem::path& relPath, std::string_view data, Durability durability = Durability::Full);
+
+    /**
+     * @brief writeFile     Atomically replace file by path
+     */
+    bool writeFile(const std::filesystem::path& filePath, std::string_view data, Durability durability = Durability::Full);
+
+    /**
+     * @brief getDirectorySyncCount Count of directory fsync calls made, for diagnostics of group commit
+     */
+    uint64_t getDirectorySyncCount() const;
+
+private:
+    struct DirectorySync
+    {
+        std::mutex              mx;
+        std::condition_variable cv;
+        uint64_t                requested {0};
+        uint64_t                completed {0};
+        bool                    isSyncing {false};
+    };
+
+    std::mutex                                                  m_syncsMx;
+    std::map<std::pair<dev_t, ino_t>, std::unique_ptr<DirectorySync> > m_directorySyncs;
+    std::atomic<uint64_t>                                       m_directorySyncCount {0};
+    std::atomic<uint64_t>                                       m_tempCounter {0};
+
+    bool writeAt(int dirFd, const std::string& fileName, std::string_view data, Durability durability);
+    int createTempFile(int dirFd, const std::string& fileName, std::string& tempName);
+    bool syncDirectory(int dirFd);
+};
+
+} // namespace Common
@@ -0,0 +1,738 @@
+#include "backupengine.hpp"
+
+#include "atomicfilewriter.hpp"
+#include "utility.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h> // FICLONE
+#endif
+
+namespace Common {
+
+namespace {
+
+constexpr const char* OBJECTS_DIR       {"objects"};
+constexpr const char* GENERATIONS_DIR   {"generations"};
+constexpr const char* MANIFEST_SUFFIX   {".manifest"};
+constexpr const char* MANIFEST_HEADER   {"COMMONBACKUP 2"};
+constexpr const char* MANIFEST_HEADER_V1 {"COMMONBACKUP 1"};    // Without snapshot time, ctime and inode
+constexpr std::size_t COPY_CHUNK_SIZE   {1 << 20};
+constexpr int         CHANGED_FILE_ATTEMPTS {3};
+constexpr int64_t     TIMESTAMP_TICK_NS {10000000};   // Granularity of coarse clock, used for file timestamps (jiffy at HZ=100)
+
+/**
+ * @brief The Hash128 class Streaming MurmurHash3 x64 128 of file content
+ */
+class Hash128
+{
+public:
+    void update(const char* pData, std::size_t size) {
+        m_length += size;
+        if (m_tailSize != 0) {
+            auto count = std::min(size, sizeof(m_tail) - m_tailSize);
+            std::memcpy(m_tail + m_tailSize, pData, count);
+            m_tailSize += count;
+            pData += count;
+            size -= count;
+            if (m_tailSize < sizeof(m_tail)) {
+                return;
+            }
+            processBlock(m_tail);
+            m_tailSize = 0;
+        }
+        for (; size >= sizeof(m_tail); pData += sizeof(m_tail), size -= sizeof(m_tail)) {
+            processBlock(pData);
+        }
+        std::memcpy(m_tail, pData, size);
+        m_tailSize = size;
+    }
+
+    std::string finish() {
+        uint64_t k1 {0};
+        uint64_t k2 {0};
+        for (auto i = m_tailSize; i > 8; --i) {
+            k2 = (k2 << 8) | uint8_t(m_tail[i - 1]);
+        }
+        for (auto i = std::min<std::size_t>(m_tailSize, 8); i > 0; --i) {
+            k1 = (k1 << 8) | uint8_t(m_tail[i - 1]);
+        }
+        if (m_tailSize > 8) {
+            k2 *= C2; k2 = rotl(k2, 33); k2 *= C1; m_h2 ^= k2;
+        }
+        if (m_tailSize > 0) {
+            k1 *= C1; k1 = rotl(k1, 31); k1 *= C2; m_h1 ^= k1;
+        }
+
+        m_h1 ^= m_length;
+        m_h2 ^= m_length;
+        m_h1 += m_h2;
+        m_h2 += m_h1;
+        m_h1 = fmix(m_h1);
+        m_h2 = fmix(m_h2);
+        m_h1 += m_h2;
+        m_h2 += m_h1;
+
+        char res[33];
+        std::snprintf(res, sizeof(res), "%016llx%016llx", static_cast<unsigned long long>(m_h1), static_cast<unsigned long long>(m_h2));
+        return res;
+    }
+
+private:
+    static constexpr uint64_t C1 {0x87c37b91114253d5ULL};
+    static constexpr uint64_t C2 {0x4cf5ad432745937fULL};
+
+    uint64_t    m_h1 {0};
+    uint64_t    m_h2 {0};
+    uint64_t    m_length {0};
+    char        m_tail[16];
+    std::size_t m_tailSize {0};
+
+    static uint64_t rotl(uint64_t v, int shift) {
+        return (v << shift) | (v >> (64 - shift));
+    }
+
+    static uint64_t fmix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    void processBlock(const char* pBlock) {
+        uint64_t k1;
+        uint64_t k2;
+        std::memcpy(&k1, pBlock, sizeof(k1));
+        std::memcpy(&k2, pBlock + sizeof(k1), sizeof(k2));
+
+        k1 *= C1; k1 = rotl(k1, 31); k1 *= C2; m_h1 ^= k1;
+        m_h1 = rotl(m_h1, 27); m_h1 += m_h2; m_h1 = m_h1 * 5 + 0x52dce729;
+        k2 *= C2; k2 = rotl(k2, 33); k2 *= C1; m_h2 ^= k2;
+        m_h2 = rotl(m_h2, 31); m_h2 += m_h1; m_h2 = m_h2 * 5 + 0x38495ab5;
+    }
+};
+
+/**
+ * @brief The IoRateLimiter class Limits bytes per second, shared by all workers
+ */
+class IoRateLimiter
+{
+public:
+    explicit IoRateLimiter(uint64_t bytesPerSecond) : m_bytesPerSecond {bytesPerSecond} {}
+
+    void acquire(uint64_t bytes) {
+        if (m_bytesPerSecond == 0) {
+            return;
+        }
+        std::chrono::steady_clock::time_point startTime;
+        {
+            std::lock_guard lock(m_mx);
+            m_nextTime = std::max(m_nextTime, std::chrono::steady_clock::now());
+            startTime = m_nextTime;
+            m_nextTime += std::chrono::nanoseconds(bytes * 1000000000ULL / m_bytesPerSecond);
+        }
+        std::this_thread::sleep_until(startTime);
+    }
+
+private:
+    uint64_t                                m_bytesPerSecond;
+    std::mutex                              m_mx;
+    std::chrono::steady_clock::time_point   m_nextTime;
+};
+
+/**
+ * @brief The FdGuard class Closes descriptor on scope exit
+ */
+class FdGuard
+{
+public:
+    explicit FdGuard(int fd) : m_fd {fd} {}
+    ~FdGuard() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+    int get() const {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+struct ManifestEntry
+{
+    int             dtype {0};
+    std::string     hash;
+    uint64_t        size {0};
+    int64_t         mtimeNs {0};
+    int64_t         ctimeNs {0};
+    uint64_t        inode {0};
+    uint32_t        mode {0644};
+    std::string     relPath;
+};
+
+struct Manifest
+{
+    int64_t                     snapshotNs {INT64_MAX};     // Time before files were checked
+    std::vector<ManifestEntry>  entries;
+};
+
+int64_t toNs(const struct timespec& time) {
+    return int64_t(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+int64_t mtimeNs(const struct stat& fileStat) {
+    return toNs(fileStat.st_mtim);
+}
+
+/**
+ * @brief isUnchangedSince  Check file by status, recorded in previous snapshot
+ * @note File, modified in the same timestamp tick as it was checked, has the same mtime as before change.
+ *       Such "racy" entries are hashed again, like racily clean entries of git index
+ */
+bool isUnchangedSince(const ManifestEntry& prevEntry, int64_t prevSnapshotNs, const ManifestEntry& entry) {
+    return (prevEntry.size == entry.size && prevEntry.mtimeNs == entry.mtimeNs &&
+            prevEntry.ctimeNs == entry.ctimeNs && prevEntry.inode == entry.inode &&
+            prevEntry.mtimeNs + TIMESTAMP_TICK_NS < prevSnapshotNs);
+}
+
+/**
+ * @brief isSafeRelativePath    Path stays inside directory: not absolute and without ".." after normalization
+ */
+bool isSafeRelativePath(const std::filesystem::path& relPath) {
+    auto normalPath = relPath.lexically_normal();
+    if (normalPath.has_root_path() || !normalPath.has_filename()) {
+        return false;
+    }
+    return std::none_of(normalPath.begin(), normalPath.end(), [](const std::filesystem::path& part) {
+        return part == "..";
+    });
+}
+
+bool isObjectHash(const std::string& hash) {
+    return (hash.size() == 32 && std::all_of(hash.begin(), hash.end(), [](char c) {
+        return ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'));
+    }));
+}
+
+std::string manifestFileName(uint64_t generation) {
+    char res[32];
+    std::snprintf(res, sizeof(res), "%012llu", static_cast<unsigned long long>(generation));
+    return res + std::string(MANIFEST_SUFFIX);
+}
+
+std::string formatManifest(const Manifest& manifest) {
+    std::ostringstream res;
+    res << MANIFEST_HEADER << '\t' << manifest.snapshotNs << '\n';
+    for (auto& entry : manifest.entries) {
+        res << entry.dtype << '\t' << entry.hash << '\t' << entry.size << '\t' << entry.mtimeNs << '\t'
+            << entry.ctimeNs << '\t' << entry.inode << '\t' << entry.mode << '\t' << entry.relPath << '\n';
+    }
+    return res.str();
+}
+
+bool readManifest(const std::filesystem::path& manifestPath, Manifest& res) {
+    std::ifstream input(manifestPath);
+    std::string line;
+    if (!std::getline(input, line)) {
+        return false;
+    }
+    std::istringstream headerStream(line);
+    bool isV1 {line == MANIFEST_HEADER_V1};
+    res.snapshotNs = INT64_MAX; // All entries of old manifest are hashed again
+    if (!isV1 && (line.compare(0, std::strlen(MANIFEST_HEADER), MANIFEST_HEADER) != 0 ||
+                  !(headerStream.ignore(std::strlen(MANIFEST_HEADER)) >> res.snapshotNs))) {
+        return false;
+    }
+
+    res.entries.clear();
+    while (std::getline(input, line)) {
+        std::istringstream lineStream(line);
+        ManifestEntry entry;
+        if (!(lineStream >> entry.dtype >> entry.hash >> entry.size >> entry.mtimeNs) ||
+            (!isV1 && !(lineStream >> entry.ctimeNs >> entry.inode)) ||
+            !(lineStream >> entry.mode) || lineStream.get() != '\t') {
+            return false;
+        }
+        std::getline(lineStream, entry.relPath);
+        res.entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool hashFile(int fd, IoRateLimiter& limiter, std::string& res) {
+    Hash128 hash;
+    std::vector<char> buffer(COPY_CHUNK_SIZE);
+    off_t offset {0};
+    while (true) {
+        auto readBytes = ::pread(fd, buffer.data(), buffer.size(), offset);
+        if (readBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (readBytes == 0) {
+            break;
+        }
+        limiter.acquire(readBytes);
+        hash.update(buffer.data(), readBytes);
+        offset += readBytes;
+    }
+    res = hash.finish();
+    return true;
+}
+
+/**
+ * @brief compareFiles  Compare content of files
+ * @param isSame        Result of comparison
+ * @return              false on read error
+ */
+bool compareFiles(int firstFd, int secondFd, IoRateLimiter& limiter, bool& isSame) {
+    struct stat firstStat;
+    struct stat secondStat;
+    if (::fstat(firstFd, &firstStat) != 0 || ::fstat(secondFd, &secondStat) != 0) {
+        return false;
+    }
+    isSame = (firstStat.st_size == secondStat.st_size);
+
+    std::vector<char> firstBuffer(COPY_CHUNK_SIZE);
+    std::vector<char> secondBuffer(COPY_CHUNK_SIZE);
+    for (off_t offset = 0; isSame && offset < firstStat.st_size; ) {
+        auto firstBytes = ::pread(firstFd, firstBuffer.data(), firstBuffer.size(), offset);
+        auto secondBytes = (firstBytes > 0 ? ::pread(secondFd, secondBuffer.data(), firstBytes, offset) : firstBytes);
+        if ((firstBytes < 0 || secondBytes < 0) && errno == EINTR) {
+            continue;
+        }
+        if (firstBytes < 0 || secondBytes < 0) {
+            return false;
+        }
+        limiter.acquire(firstBytes * 2);
+        isSame = (firstBytes == secondBytes && firstBytes != 0 &&
+                  std::memcmp(firstBuffer.data(), secondBuffer.data(), firstBytes) == 0);
+        offset += firstBytes;
+    }
+    return true;
+}
+
+/**
+ * @brief copyFileData Copy content with reflink if filesystem supports it, copy_file_range or read/write otherwise
+ */
+bool copyFileData(int srcFd, int dstFd, IoRateLimiter& limiter, uint64_t& bytesCopied) {
+#ifdef FICLONE
+    if (::ioctl(dstFd, FICLONE, srcFd) == 0) {
+        return true; // Blocks are shared, nothing is copied
+    }
+#endif
+
+    bool isCopyRangeSupported {true};
+    loff_t offset {0};
+    std::vector<char> buffer;
+    while (true) {
+        limiter.acquire(COPY_CHUNK_SIZE);
+        ssize_t copiedBytes {-1};
+        if (isCopyRangeSupported) {
+            loff_t outOffset {offset};
+            copiedBytes = ::copy_file_range(srcFd, &offset, dstFd, &outOffset, COPY_CHUNK_SIZE, 0);
+            if (copiedBytes < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+                isCopyRangeSupported = false;
+                continue;
+            }
+        } else {
+            buffer.resize(COPY_CHUNK_SIZE);
+            copiedBytes = ::pread(srcFd, buffer.data(), buffer.size(), offset);
+            for (ssize_t written = 0; copiedBytes > 0 && written < copiedBytes; ) {
+                auto res = ::pwrite(dstFd, buffer.data() + written, copiedBytes - written, offset + written);
+                if (res < 0 && errno != EINTR) {
+                    return false;
+                }
+                written += std::max<ssize_t>(res, 0);
+            }
+            offset += std::max<ssize_t>(copiedBytes, 0);
+        }
+
+        if (copiedBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (copiedBytes == 0) {
+            return true;
+        }
+        bytesCopied += copiedBytes;
+    }
+}
+
+/**
+ * @brief replaceFromFd Copy content into temporary file in directory and rename it to target name
+ * @param isSourceValid Optional check of source after copy. File is not renamed if it fails
+ */
+bool replaceFromFd(int srcFd, int dirFd, const std::string& fileName, mode_t mode, IoRateLimiter& limiter, uint64_t& bytesCopied,
+                   const std::function<bool()>& isSourceValid = {}) {
+    static std::atomic<uint64_t> tempCounter {0};
+    auto tempName = "." + fileName + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(++tempCounter);
+    FdGuard tempFd(::openat(dirFd, tempName.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, mode));
+    if (tempFd.get() < 0) {
+        return false;
+    }
+    if (!copyFileData(srcFd, tempFd.get(), limiter, bytesCopied) ||
+        ::fchmod(tempFd.get(), mode) != 0 ||
+        ::fdatasync(tempFd.get()) != 0 ||
+        (isSourceValid && !isSourceValid()) ||
+        ::renameat(dirFd, tempName.c_str(), dirFd, fileName.c_str()) != 0) {
+        ::unlinkat(dirFd, tempName.c_str(), 0);
+        return false;
+    }
+    return true;
+}
+
+bool makeDirectory(int dirFd, const char* pName) {
+    return (::mkdirat(dirFd, pName, 0755) == 0 || errno == EEXIST);
+}
+
+} // namespace
+
+
+BackupEngine::BackupEngine(DirectoryManager &dirManager) :
+    m_dirManager {dirManager}
+{
+
+}
+
+bool BackupEngine::createBackup(const BackupOptions &options, BackupStats *pStats)
+{
+    std::lock_guard lock(m_backupMx);
+    auto backupFd = m_dirManager.getDirectoryFd(DirectoryType::Backup);
+    if (backupFd < 0 || !makeDirectory(backupFd, OBJECTS_DIR) || !makeDirectory(backupFd, GENERATIONS_DIR)) {
+        setError("Backup directory is not available: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    FdGuard objectsFd(::openat(backupFd, OBJECTS_DIR, O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (objectsFd.get() < 0) {
+        setError("Failed to open objects directory: " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    // Previous snapshot to skip hashing of unchanged files
+    auto generations = getGenerations();
+    auto& backupPath = m_dirManager.getDirectory(DirectoryType::Backup);
+    std::map<std::pair<int, std::string>, ManifestEntry> prevEntries;
+    Manifest prevManifest;
+    if (!generations.empty() && readManifest(backupPath / GENERATIONS_DIR / manifestFileName(generations.back()), prevManifest)) {
+        for (auto& entry : prevManifest.entries) {
+            prevEntries.emplace(std::make_pair(entry.dtype, entry.relPath), std::move(entry));
+        }
+    }
+
+    // Taken before any file is checked, so file changed after its check has mtime after snapshot time
+    Manifest manifest;
+    struct timespec snapshotTime;
+    ::clock_gettime(CLOCK_REALTIME, &snapshotTime);
+    manifest.snapshotNs = toNs(snapshotTime);
+
+    auto& entries = manifest.entries;
+    for (auto dtype : options.directories) {
+        auto& rootPath = m_dirManager.getDirectory(dtype);
+        std::error_code ec;
+        std::filesystem::recursive_directory_iterator dirIt(rootPath, ec);
+        if (rootPath.empty() || ec) {
+            setError("Directory is not available, type: " + std::to_string(dtype));
+            return false;
+        }
+        for (; dirIt != std::filesystem::recursive_directory_iterator(); dirIt.increment(ec)) {
+            if (dirIt->path() == backupPath) {
+                dirIt.disable_recursion_pending();
+                continue;
+            }
+            // Symlinks are not followed: files are opened with O_NOFOLLOW and target may be outside of directory
+            std::error_code statusEc;
+            auto relPath = dirIt->path().lexically_relative(rootPath).string();
+            if (dirIt->is_symlink(statusEc) || !dirIt->is_regular_file(statusEc) || relPath.find('\n') != std::string::npos) {
+                continue;
+            }
+            ManifestEntry entry;
+            entry.dtype = dtype;
+            entry.relPath = std::move(relPath);
+            entries.push_back(std::move(entry));
+        }
+        if (ec) {
+            setError("Failed to list directory, type: " + std::to_string(dtype) + ": " + ec.message()); // Snapshot would be incomplete
+            return false;
+        }
+    }
+
+    IoRateLimiter limiter(options.ioRateLimit);
+    std::atomic<std::size_t> filesHashed {0};
+    std::atomic<std::size_t> filesCopied {0};
+    std::atomic<uint64_t> bytesCopied {0};
+    std::mutex errorMx;
+    std::mutex copyMx;
+    std::condition_variable copyCv;
+    std::set<std::string> copyingObjects;
+    std::vector<char> removedEntries(entries.size(), false);
+    auto processEntry = [&](std::size_t i) {
+        auto& entry = entries[i];
+        auto reportError = [&](const std::string& errorText) {
+            std::lock_guard errorLock(errorMx);
+            setError(errorText + ": " + entry.relPath);
+            return false;
+        };
+
+        FdGuard fileFd(m_dirManager.openFile(entry.dtype, entry.relPath, O_RDONLY | O_NOFOLLOW));
+        if (fileFd.get() < 0 && errno == ENOENT) {
+            removedEntries[i] = true; // Removed after listing, as if it was removed before backup
+            return true;
+        }
+        if (fileFd.get() < 0) {
+            return reportError("Failed to open file");
+        }
+        auto prevIt = prevEntries.find({entry.dtype, entry.relPath});
+        for (int attempt = 0; attempt < CHANGED_FILE_ATTEMPTS; ++attempt) {
+            struct stat fileStat;
+            if (::fstat(fileFd.get(), &fileStat) != 0) {
+                return reportError("Failed to get file status");
+            }
+            entry.size = fileStat.st_size;
+            entry.mtimeNs = mtimeNs(fileStat);
+            entry.ctimeNs = toNs(fileStat.st_ctim);
+            entry.inode = fileStat.st_ino;
+            entry.mode = fileStat.st_mode & 07777;
+
+            struct stat objectStat;
+            if (!options.isHashingAll && prevIt != prevEntries.end() &&
+                isUnchangedSince(prevIt->second, prevManifest.snapshotNs, entry) &&
+                ::fstatat(objectsFd.get(), prevIt->second.hash.c_str(), &objectStat, 0) == 0) {
+                entry.hash = prevIt->second.hash;
+                return true;
+            }
+
+            if (!hashFile(fileFd.get(), limiter, entry.hash)) {
+                return reportError("Failed to read file");
+            }
+            ++filesHashed;
+
+            // File must not be changed while it is hashed and copied, otherwise content does not match hash
+            bool isChanged {false};
+            auto isUnchanged = [&]() {
+                struct stat afterStat;
+                isChanged = (::fstat(fileFd.get(), &afterStat) != 0 ||
+                             uint64_t(afterStat.st_size) != entry.size || mtimeNs(afterStat) != entry.mtimeNs);
+                return !isChanged;
+            };
+
+            // Files with same content may be processed by several workers, only one of them copies it
+            std::unique_lock copyLock(copyMx);
+            copyCv.wait(copyLock, [&]() {
+                return (copyingObjects.count(entry.hash) == 0);
+            });
+            if (::fstatat(objectsFd.get(), entry.hash.c_str(), &objectStat, 0) == 0) {
+                copyLock.unlock();
+
+                // Hash is not cryptographic, content is compared, so other file is never restored in place of this one
+                bool isSame {false};
+                FdGuard objectFd(::openat(objectsFd.get(), entry.hash.c_str(), O_RDONLY | O_CLOEXEC));
+                if (objectFd.get() < 0 || !compareFiles(fileFd.get(), objectFd.get(), limiter, isSame)) {
+                    return reportError("Failed to compare file with backup object");
+                }
+                if (isUnchanged()) {
+                    return (isSame || reportError("Hash collision with content of other file"));
+                }
+                continue;
+            }
+            copyingObjects.insert(entry.hash);
+            copyLock.unlock();
+
+            uint64_t copied {0};
+            auto isCopied = replaceFromFd(fileFd.get(), objectsFd.get(), entry.hash, 0444, limiter, copied, isUnchanged);
+            copyLock.lock();
+            copyingObjects.erase(entry.hash);
+            copyLock.unlock();
+            copyCv.notify_all();
+            if (isCopied) {
+                ++filesCopied;
+                bytesCopied += copied;
+                return true;
+            }
+            if (!isChanged) {
+                return reportError("Failed to copy file");
+            }
+        }
+        return reportError("File is changing during backup");
+    };
+    if (!forEachParallel(entries.size(), options.workersCount, processEntry)) {
+        return false;
+    }
+    for (std::size_t i = entries.size(); i > 0; --i) {
+        if (removedEntries[i - 1]) {
+            entries.erase(entries.begin() + (i - 1));
+        }
+    }
+
+    // Objects must be durable before manifest refers to them
+    if (::fsync(objectsFd.get()) != 0) {
+        setError("Failed to sync objects directory: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    std::sort(entries.begin(), entries.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+        return std::tie(a.dtype, a.relPath) < std::tie(b.dtype, b.relPath);
+    });
+    auto generation = (generations.empty() ? 1 : generations.back() + 1);
+    if (!AtomicFileWriter::getInstance().writeFile(backupPath / GENERATIONS_DIR / manifestFileName(generation),
+                                                   formatManifest(manifest), Durability::Full)) {
+        setError("Failed to write manifest");
+        return false;
+    }
+    COMPLOG_INFO("Backup created, generation:", generation, "files:", entries.size(), "copied:", filesCopied.load());
+
+    if (pStats) {
+        pStats->generation = generation;
+        pStats->filesCount = entries.size();
+        pStats->filesHashed = filesHashed;
+        pStats->filesCopied = filesCopied;
+        pStats->bytesCopied = bytesCopied;
+    }
+    return applyRetention(options.keepGenerations);
+}
+
+bool BackupEngine::restoreBackup(uint64_t generation, const std::vector<int> &directories)
+{
+    std::lock_guard lock(m_backupMx);
+    auto& backupPath = m_dirManager.getDirectory(DirectoryType::Backup);
+    Manifest manifest;
+    if (!readManifest(backupPath / GENERATIONS_DIR / manifestFileName(generation), manifest)) {
+        setError("Failed to read manifest of generation " + std::to_string(generation));
+        return false;
+    }
+    auto& entries = manifest.entries;
+
+    // Manifest may be damaged or forged, files must not be written outside of their directories
+    for (auto& entry : entries) {
+        if (!isSafeRelativePath(entry.relPath) || !isObjectHash(entry.hash)) {
+            setError("Invalid manifest entry of generation " + std::to_string(generation) + ": " + entry.relPath);
+            return false;
+        }
+    }
+    if (!directories.empty()) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&directories](const ManifestEntry& entry) {
+            return std::find(directories.begin(), directories.end(), entry.dtype) == directories.end();
+        }), entries.end());
+    }
+
+    IoRateLimiter limiter(0);
+    std::mutex errorMx;
+    auto restoreEntry = [&](std::size_t i) {
+        auto& entry = entries[i];
+        auto reportError = [&](const std::string& errorText) {
+            std::lock_guard errorLock(errorMx);
+            setError(errorText + ": " + entry.relPath + " " + std::strerror(errno));
+            return false;
+        };
+
+        auto relPath = std::filesystem::path(entry.relPath).lexically_normal();
+        std::error_code ec;
+        std::filesystem::create_directories(m_dirManager.getDirectory(entry.dtype) / relPath.parent_path(), ec);
+        auto dirFd = m_dirManager.getDirectoryFd(entry.dtype);
+        FdGuard parentFd(relPath.has_parent_path() ? ::openat(dirFd, relPath.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) : -1);
+        FdGuard objectFd(::open((backupPath / OBJECTS_DIR / entry.hash).c_str(), O_RDONLY | O_CLOEXEC));
+        if (dirFd < 0 || (relPath.has_parent_path() && parentFd.get() < 0) || objectFd.get() < 0) {
+            return reportError("Failed to open file for restore");
+        }
+
+        uint64_t copied {0};
+        if (!replaceFromFd(objectFd.get(), relPath.has_parent_path() ? parentFd.get() : dirFd,
+                           relPath.filename().string(), entry.mode, limiter, copied)) {
+            return reportError("Failed to restore file");
+        }
+        return true;
+    };
+    if (!forEachParallel(entries.size(), std::thread::hardware_concurrency(), restoreEntry)) {
+        return false;
+    }
+    COMPLOG_INFO("Backup restored, generation:", generation, "files:", entries.size());
+    return true;
+}
+
+std::vector<uint64_t> BackupEngine::getGenerations() const
+{
+    std::vector<uint64_t> res;
+    std::error_code ec;
+    for (auto& dirEntry : std::filesystem::directory_iterator(m_dirManager.getDirectory(DirectoryType::Backup) / GENERATIONS_DIR, ec)) {
+        auto fileName = dirEntry.path().filename().string();
+        if (dirEntry.path().extension() != MANIFEST_SUFFIX || fileName.front() == '.') {
+            continue;
+        }
+        res.push_back(std::strtoull(fileName.c_str(), nullptr, 10));
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+std::string BackupEngine::getLastErrorText() const
+{
+    return m_lastError;
+}
+
+void BackupEngine::setError(const std::string &errorText)
+{
+    m_lastError = errorText;
+    COMPLOG_ERROR("BackupEngine:", errorText);
+}
+
+bool BackupEngine::applyRetention(std::size_t keepGenerations)
+{
+    auto generations = getGenerations();
+    if (keepGenerations == 0 || generations.size() <= keepGenerations) {
+        return true;
+    }
+
+    auto generationsPath = m_dirManager.getDirectory(DirectoryType::Backup) / GENERATIONS_DIR;
+    std::error_code ec;
+    for (std::size_t i = 0; i + keepGenerations < generations.size(); ++i) {
+        std::filesystem::remove(generationsPath / manifestFileName(generations[i]), ec);
+    }
+
+    // Remove objects, not used by remaining generations. Temporary files are left only by failed copies
+    std::set<std::string> usedObjects;
+    for (auto i = generations.size() - keepGenerations; i < generations.size(); ++i) {
+        Manifest manifest;
+        if (!readManifest(generationsPath / manifestFileName(generations[i]), manifest)) {
+            setError("Failed to read manifest of generation " + std::to_string(generations[i]));
+            return false;
+        }
+        for (auto& entry : manifest.entries) {
+            usedObjects.insert(std::move(entry.hash));
+        }
+    }
+    for (auto& dirEntry : std::filesystem::directory_iterator(m_dirManager.getDirectory(DirectoryType::Backup) / OBJECTS_DIR, ec)) {
+        if (usedObjects.count(dirEntry.path().filename().string()) == 0) {
+            std::filesystem::remove(dirEntry.path(), ec);
+        }
+    }
+    return true;
+}
+
+} // namespace Common
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "directorymanager.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The BackupOptions struct Parameters of @ref BackupEngine::createBackup()
+ */
+struct BackupOptions
+{
+    std::vector<int>    directories {DirectoryType::Config, DirectoryType::Data};   // Directory types to snapshot
+    unsigned            workersCount {4};
+    uint64_t            ioRateLimit {0};        // Bytes per second of read and copy, 0 - unlimited
+    std::size_t         keepGenerations {7};    // Older generations and their unused files are removed
+    bool                isHashingAll {false};   // Hash every file, even if its status is unchanged since last snapshot
+};
+
+/**
+ * @brief The BackupStats struct Result of backup
+ */
+struct BackupStats
+{
+    uint64_t    generation {0};
+    std::size_t filesCount {0};     // Files in snapshot
+    std::size_t filesHashed {0};    // Files read to compute hash
+    std::size_t filesCopied {0};    // Files with new content
+    uint64_t    bytesCopied {0};
+};
+
+/**
+ * @brief The BackupEngine class Incremental deduplicating snapshots into DirectoryType::Backup
+ * @note Backup directory contains content-addressed files "objects/<hash>" and
+ *       "generations/<generation>.manifest" files with list of snapshot files.
+ *       File is copied only if there is no object with same content yet.
+ *       File is hashed again if its size, mtime, ctime or inode differs from previous snapshot,
+ *       or if it was modified close to the time previous snapshot was taken.
+ *       Content of file, which hash matches existing object, is compared with object byte by byte.
+ *       Symlinks are skipped, files removed during backup are left out of snapshot
+ */
+class BackupEngine : public boost::noncopyable
+{
+public:
+    explicit BackupEngine(DirectoryManager& dirManager = DirectoryManager::getInstance());
+
+    /**
+     * @brief createBackup  Create new generation of snapshot
+     * @param options       Backup parameters
+     * @param pStats        Optional result statistics
+     * @return              true if snapshot is complete
+     */
+    bool createBackup(const BackupOptions& options = {}, BackupStats* pStats = nullptr);
+
+    /**
+     * @brief restoreBackup Restore files of snapshot into their directories. Files, not in snapshot, are kept
+     * @param generation    Generation from @ref getGenerations()
+     * @param directories   Directory types to restore, all if empty
+     * @return              true if all files are restored
+     */
+    bool restoreBackup(uint64_t generation, const std::vector<int>& directories = {});
+
+    /**
+     * @brief getGenerations    Get existing generations, sorted from oldest
+     */
+    std::vector<uint64_t> getGenerations() const;
+
+    std::string getLastErrorText() const;
+
+private:
+    DirectoryManager&   m_dirManager;
+    std::mutex          m_backupMx;     // One operation on backup directory at time
+    std::string         m_lastError;
+
+    void setError(const std::string& errorText);
+    bool applyRetention(std::size_t keepGenerations);
+};
+
+} // namespace Common
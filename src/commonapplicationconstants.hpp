@@ -5,6 +5,7 @@
 #define APP_EXITCODE_FAILURE              2
 #define APP_EXITCODE_EXCEPTION            3
 #define APP_EXITCODE_UNKNOWN_EXCEPTION    4
+#define APP_EXITCODE_SHUTDOWN_TIMEOUT     5
 
 namespace Common
 {
@@ -202,6 +202,10 @@ QImage readImage(const QString &filePath) {
     return {};
 }
 
+Common::Future<QImage> readImageAsync(const QString &filePath, Common::Executor &executor) {
+    return executor.submit([filePath]() { return readImage(filePath); });
+}
+
 }  // namespace CommonFunctions
 
 #endif // COMPONENTS_IS_ENABLED_QT
@@ -9,6 +9,8 @@
 #include <QImage>
 #include <QImageReader>
 
+#include "executor.hpp"
+
 namespace CommonFunctions {
 
 /**
@@ -107,6 +109,14 @@ QRectF rectFromString(const QString& iString);
  */
 QImage readImage(const QString& filePath);
 
+/**
+ * @brief readImageAsync    Считать изображение из файла в executor
+ * @param filePath
+ * @param executor
+ * @return                  Future с NULL QImage если не удалось
+ */
+Common::Future<QImage> readImageAsync(const QString& filePath, Common::Executor& executor = Common::Executor::getInstance());
+
 }  // namespace CommonFunctions
 
 #endif // QT_WIDGETS_LIB
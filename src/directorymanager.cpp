@@ -1,7 +1,25 @@
 #include "directorymanager.hpp"
 
+#include "tracing.hpp"
+
+#include <mutex>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace Common {
 
+DirectoryManager::~DirectoryManager()
+{
+    for (auto& pHandle : m_handles) {
+        if (auto fd = pHandle->fd.load(std::memory_order_relaxed); fd >= 0) {
+            ::close(fd);
+        }
+    }
+    for (auto fd : m_retiredFds) {
+        ::close(fd);
+    }
+}
 
 DirectoryManager &DirectoryManager::getInstance() {
     static DirectoryManager inst;
@@ -9,25 +27,37 @@ DirectoryManager &DirectoryManager::getInstance() {
 }
 
 bool DirectoryManager::init() {
-    std::filesystem::create_directory(std::filesystem::current_path() / m_rootdir);
-    auto curdir = std::filesystem::path(m_rootdir);
+    COMMON_TRACE_SCOPE("DirectoryManager::init");
+    std::filesystem::path rootdir;
+    std::map<int, std::filesystem::path> dirPaths;
+    {
+        std::shared_lock lock(m_mx);
+        rootdir = m_rootdir;
+        for (auto& [dirtype, pHandle] : m_dirPaths) {
+            dirPaths.emplace(dirtype, pHandle->path);
+        }
+    }
+
+    std::filesystem::create_directory(std::filesystem::current_path() / rootdir);
+    auto curdir = std::filesystem::path(rootdir);
     if (    !std::filesystem::exists(curdir) ||
         !std::filesystem::is_directory(curdir) ||
         !isDirectoryWritable(curdir)) {
-        std::cerr << "Root dir:       " << m_rootdir << std::endl;
+        std::cerr << "Root dir:       " << rootdir << std::endl;
         std::cerr << "Current dir:    " << std::filesystem::current_path() << std::endl;
         std::cerr << "Invalid directory (not exist or not readable)";
         return false;
     }
 
-    for (auto& [dirtype, dirpath] : m_dirPaths) {
+    for (auto& [dirtype, dirpath] : dirPaths) {
         if (std::filesystem::exists(dirpath.generic_string())) {
             std::cout << "[  OK  ] DirectoryManager check: Directory exist. Path: " << dirpath << std::endl;
             continue;
         }
 
-        if (!std::filesystem::create_directory(dirpath)) {
-            std::cerr << std::string(std::string("DirectoryManager: Error creating directory. Path: ") + dirpath.generic_string());
+        std::error_code ec;
+        if (!std::filesystem::create_directory(dirpath, ec)) {
+            std::cerr << std::string(std::string("DirectoryManager: Error creating directory. Path: ") + dirpath.generic_string()) << ' ' << ec.message() << std::endl;
             return false;
         }
         std::cout << "[  OK  ] DirectoryManager check: created directory. Path: " << dirpath << std::endl;
@@ -35,43 +65,173 @@ bool DirectoryManager::init() {
     return true;
 }
 
+Future<bool> DirectoryManager::initAsync(Executor &executor) {
+    return executor.submit([this]() { return init(); });
+}
+
 void DirectoryManager::setRootPath(const std::filesystem::path &rootPath) {
-    m_rootdir = rootPath.wstring();
-    registerDirectory(DirectoryType::Config,    m_rootdir / "config");
-    registerDirectory(DirectoryType::Data,      m_rootdir / "data");
-    registerDirectory(DirectoryType::Logs,      m_rootdir / "log");
-    registerDirectory(DirectoryType::Plugins,   m_rootdir / "plugins");
-    registerDirectory(DirectoryType::Backup,    m_rootdir / "backup");
-    registerDirectory(DirectoryType::Temporary, m_rootdir / "tmp");
+    COMMON_TRACE_SCOPE("DirectoryManager::setRootPath");
+    std::filesystem::path rootdir = rootPath.wstring();
+    {
+        std::unique_lock lock(m_mx);
+        m_rootdir = rootdir;
+    }
+    registerDirectory(DirectoryType::Config,    rootdir / "config");
+    registerDirectory(DirectoryType::Data,      rootdir / "data");
+    registerDirectory(DirectoryType::Logs,      rootdir / "log");
+    registerDirectory(DirectoryType::Plugins,   rootdir / "plugins");
+    registerDirectory(DirectoryType::Backup,    rootdir / "backup");
+    registerDirectory(DirectoryType::Temporary, rootdir / "tmp");
     init();
 }
 
 std::filesystem::path DirectoryManager::getRootPath() const
 {
+    std::shared_lock lock(m_mx);
     return m_rootdir;
 }
 
-std::filesystem::path DirectoryManager::getDirectory(int dtype) const {
+const std::filesystem::path& DirectoryManager::getDirectory(int dtype) const {
+    static const std::filesystem::path emptyPath;
+    auto pHandle = findHandle(dtype);
+    return (pHandle ? pHandle->path : emptyPath);
+}
+
+const std::filesystem::path& DirectoryManager::getDirectoryStatic(int dtype) {
+    auto& inst = getInstance();
+    return inst.getDirectory(dtype);
+}
+
+int DirectoryManager::getDirectoryFd(int dtype) const
+{
+    auto pHandle = findHandle(dtype);
+    if (!pHandle) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    auto fd = pHandle->fd.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        return fd;
+    }
+    auto newFd = ::open(pHandle->path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (newFd < 0) {
+        return -1; // Not cached, directory may be created later
+    }
+    if (!pHandle->fd.compare_exchange_strong(fd, newFd, std::memory_order_acq_rel)) {
+        ::close(newFd); // Opened concurrently by other thread
+        return fd;
+    }
+    return newFd;
+}
+
+int DirectoryManager::openFile(int dtype, const std::filesystem::path &relPath, int flags, mode_t mode) const
+{
+    auto dirFd = getDirectoryFd(dtype);
+    if (dirFd < 0) {
+        return -1;
+    }
+    auto fd = ::openat(dirFd, relPath.c_str(), flags | O_CLOEXEC, mode);
+    if (fd < 0 && isStaleError(errno) && revalidateDirectoryFd(dtype, dirFd)) {
+        fd = ::openat(dirFd, relPath.c_str(), flags | O_CLOEXEC, mode);
+    }
+    return fd;
+}
+
+bool DirectoryManager::statFile(int dtype, const std::filesystem::path &relPath, struct stat &res) const
+{
+    auto dirFd = getDirectoryFd(dtype);
+    if (dirFd < 0) {
+        return false;
+    }
+    if (::fstatat(dirFd, relPath.c_str(), &res, 0) == 0) {
+        return true;
+    }
+    return (isStaleError(errno) && revalidateDirectoryFd(dtype, dirFd) && ::fstatat(dirFd, relPath.c_str(), &res, 0) == 0);
+}
+
+void DirectoryManager::registerDirectory(int dtype, const std::filesystem::path &dirp) {
+    auto pHandle = std::make_unique<DirectoryHandle>();
+    pHandle->path = dirp;
+
+    std::unique_lock lock(m_mx);
+    if (auto targetIt = m_dirPaths.find(dtype); targetIt != m_dirPaths.end()) {
+        if (targetIt->second->path == dirp) {
+            return;
+        }
+        // Replaced handle is kept for references to its path, descriptor may still be used by other threads
+        if (auto fd = targetIt->second->fd.exchange(-1, std::memory_order_acq_rel); fd >= 0) {
+            m_retiredFds.push_back(fd);
+        }
+    }
+    m_dirPaths[dtype] = pHandle.get();
+    m_handles.push_back(std::move(pHandle));
+}
+
+std::map<int, std::filesystem::path> DirectoryManager::getDirectories() const
+{
+    std::shared_lock lock(m_mx);
+    std::map<int, std::filesystem::path> res;
+    for (auto& [dirtype, pHandle] : m_dirPaths) {
+        res.emplace(dirtype, pHandle->path);
+    }
+    return res;
+}
+
+void DirectoryManager::resetDirectoryFd(int dtype)
+{
+    std::unique_lock lock(m_mx);
     auto targetIt = m_dirPaths.find(dtype);
     if (targetIt == m_dirPaths.end()) {
-        return {};
+        return;
+    }
+    if (auto fd = targetIt->second->fd.exchange(-1, std::memory_order_acq_rel); fd >= 0) {
+        m_retiredFds.push_back(fd);
+    }
+}
+
+const DirectoryManager::DirectoryHandle *DirectoryManager::findHandle(int dtype) const
+{
+    std::shared_lock lock(m_mx);
+    auto targetIt = m_dirPaths.find(dtype);
+    if (targetIt == m_dirPaths.end()) {
+        return nullptr;
     }
     return targetIt->second;
 }
 
-std::filesystem::path DirectoryManager::getDirectoryStatic(int dtype) {
-    auto& inst = getInstance();
-    return inst.getDirectory(dtype);
+bool DirectoryManager::isStaleError(int error)
+{
+    return (error == ENOENT || error == ESTALE);
 }
 
-void DirectoryManager::registerDirectory(int dtype, const std::filesystem::path &dirp) {
-    m_dirPaths[dtype] = dirp;
+bool DirectoryManager::revalidateDirectoryFd(int dtype, int dirFd) const
+{
+    auto savedErrno = errno;
+    auto pHandle = findHandle(dtype);
+    auto newFd = (pHandle ? ::open(pHandle->path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) : -1);
+    if (newFd < 0) {
+        errno = savedErrno;
+        return false; // Directory does not exist, error of operation stays
+    }
+
+    struct stat cachedStat, currentStat;
+    bool isReplaced = (::fstat(newFd, &currentStat) == 0 &&
+                       (::fstat(dirFd, &cachedStat) != 0 || cachedStat.st_dev != currentStat.st_dev || cachedStat.st_ino != currentStat.st_ino));
+    // Descriptor number stays the same, so threads using it never see closed or reused descriptor
+    if (isReplaced && ::dup3(newFd, dirFd, O_CLOEXEC) < 0) {
+        isReplaced = false;
+    }
+    ::close(newFd);
+    if (!isReplaced) {
+        errno = savedErrno;
+    }
+    return isReplaced;
 }
 
 bool DirectoryManager::isDirectoryWritable(const std::filesystem::path &p) const
 {
-    auto perms = std::filesystem::status(p).permissions();
-    return (perms & std::filesystem::perms::owner_write) != std::filesystem::perms::none; // TODO: Check work
+    return (::access(p.c_str(), W_OK) == 0);
 }
 
 } // namespace Common
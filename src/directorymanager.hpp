@@ -1,9 +1,18 @@
 #pragma once
 
+#include "executor.hpp"
+
 #include <Components/Logger/Logger.h>
 
-#include <map>
+#include <atomic>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace Common {
 
@@ -24,12 +33,17 @@ enum DirectoryType : int
 
 /**
  * @brief The DirectoryManager class Directory manager to handle app data
+ * @note Thread-safe. Directory descriptors are opened on first use and kept open, so files can be
+ *       opened relative to them (see @ref openFile()) without resolving full path each time.
+ *       If directory was removed or replaced, descriptor is opened again on ENOENT or ESTALE
  */
 class DirectoryManager : public boost::noncopyable
 {
 protected:
 
 public:
+    ~DirectoryManager();
+
     static DirectoryManager& getInstance();
 
     /**
@@ -50,19 +64,51 @@ public:
      */
     bool init();
 
+    /**
+     * @brief initAsync Run @ref init in executor, so that startup may continue meanwhile
+     */
+    Future<bool> initAsync(Executor& executor = Executor::getInstance());
+
     /**
      * @brief getDirectory  Get directory, registered in manager
      * @param dtype         @ref DirectoryType enum or custom value
-     * @return              Directory handle
+     * @return              Directory path or empty path, if not registered.
+     *                      Reference is valid until manager is destroyed, even if directory is registered again
      */
-    std::filesystem::path getDirectory(int dtype) const;
+    const std::filesystem::path& getDirectory(int dtype) const;
 
     /**
      * @brief getDirectoryStatic    Static equ of @ref getDirectory()
      * @param dtype
      * @return
      */
-    static std::filesystem::path getDirectoryStatic(int dtype);
+    static const std::filesystem::path& getDirectoryStatic(int dtype);
+
+    /**
+     * @brief getDirectoryFd    Get cached descriptor of directory, opened with O_DIRECTORY
+     * @param dtype             @ref DirectoryType enum or custom value
+     * @return                  Descriptor, owned by manager, or -1 (errno is set)
+     */
+    int getDirectoryFd(int dtype) const;
+
+    /**
+     * @brief openFile  Open file relative to directory, see openat(2)
+     * @param dtype     @ref DirectoryType enum or custom value
+     * @param relPath   Path relative to directory
+     * @param flags     open(2) flags, O_CLOEXEC is always added
+     * @param mode      Permissions of created file
+     * @return          Descriptor, owned by caller, or -1 (errno is set)
+     */
+    int openFile(int dtype, const std::filesystem::path& relPath, int flags, mode_t mode = 0644) const;
+
+    /**
+     * @brief statFile  Get file status relative to directory, see fstatat(2)
+     * @param dtype     @ref DirectoryType enum or custom value
+     * @param relPath   Path relative to directory
+     * @param res       Status of file
+     * @return          false if file not found or directory is not registered (errno is set)
+     */
+    bool statFile(int dtype, const std::filesystem::path& relPath, struct stat& res) const;
 
     /**
      * @brief registerDirectory Зарегистрировать пользовательский тип директории
@@ -72,10 +118,42 @@ public:
      */
     void registerDirectory(int dtype, const std::filesystem::path& dirp);
 
+    /**
+     * @brief getDirectories    Get all registered directories
+     * @return                  Map of directory type to path
+     */
+    std::map<int, std::filesystem::path> getDirectories() const;
+
+    /**
+     * @brief resetDirectoryFd  Drop cached descriptor, so it is opened again on next use.
+     *                          Required after directory was removed and created again
+     * @param dtype             @ref DirectoryType enum or custom value
+     */
+    void resetDirectoryFd(int dtype);
+
 private:
-    std::filesystem::path                   m_rootdir;
-    std::map<int, std::filesystem::path>    m_dirPaths;
+    struct DirectoryHandle
+    {
+        std::filesystem::path   path;
+        mutable std::atomic<int> fd {-1};
+    };
+
+    mutable std::shared_mutex                       m_mx;
+    std::vector<int>                                m_retiredFds;   // Descriptors may still be used by other threads
+    std::filesystem::path                           m_rootdir;
+    std::map<int, const DirectoryHandle*>           m_dirPaths;
+    std::vector<std::unique_ptr<DirectoryHandle> >  m_handles; // Handles are not freed on registration of same type to keep references valid
 
+    const DirectoryHandle* findHandle(int dtype) const;
+    static bool isStaleError(int error);
+
+    /**
+     * @brief revalidateDirectoryFd Point cached descriptor to directory, which is at registered path now
+     * @param dtype                 @ref DirectoryType enum or custom value
+     * @param dirFd                 Cached descriptor, used by failed operation
+     * @return                      true if descriptor was replaced, so operation may be retried. errno is kept otherwise
+     */
+    bool revalidateDirectoryFd(int dtype, int dirFd) const;
     bool isDirectoryWritable(const std::filesystem::path& p) const;
 };
 
@@ -0,0 +1,332 @@
+#include "directorymonitor.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/statvfs.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace Common {
+
+DirectoryMonitor::DirectoryMonitor(DirectoryManager &dirManager) :
+    m_dirManager {dirManager}
+{
+
+}
+
+DirectoryMonitor::~DirectoryMonitor()
+{
+    stop();
+}
+
+bool DirectoryMonitor::start(const DirectoryMonitorOptions &options)
+{
+    if (m_monitorThread.joinable()) {
+        return false;
+    }
+    m_options = options;
+    m_isStopping = false;
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_inotifyFd < 0 || m_timerFd < 0 || m_wakeFd < 0) {
+        COMPLOG_ERROR("DirectoryMonitor: failed to create descriptors:", std::strerror(errno));
+        closeDescriptors();
+        return false;
+    }
+
+    auto intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_options.pollInterval).count();
+    itimerspec timerSpec {};
+    timerSpec.it_interval.tv_sec = intervalNs / 1000000000;
+    timerSpec.it_interval.tv_nsec = intervalNs % 1000000000;
+    timerSpec.it_value = timerSpec.it_interval;
+    ::timerfd_settime(m_timerFd, 0, &timerSpec, nullptr);
+
+    for (auto fd : {m_inotifyFd, m_timerFd, m_wakeFd}) {
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    m_monitorThread = std::thread(&DirectoryMonitor::monitorLoop, this);
+    return true;
+}
+
+void DirectoryMonitor::stop()
+{
+    if (!m_monitorThread.joinable()) {
+        return;
+    }
+    m_isStopping = true;
+    refresh();
+    m_monitorThread.join();
+    closeDescriptors();
+    m_watched.clear();
+    m_parentWatches.clear();
+    m_lowSpaceDevices.clear();
+}
+
+bool DirectoryMonitor::isRunning() const
+{
+    return m_monitorThread.joinable();
+}
+
+void DirectoryMonitor::refresh()
+{
+    uint64_t value {1};
+    if (m_wakeFd >= 0) {
+        [[maybe_unused]] auto res = ::write(m_wakeFd, &value, sizeof(value));
+    }
+}
+
+DirectoryMonitor::SubscriptionId_t DirectoryMonitor::subscribe(Callback_t &&callback)
+{
+    std::lock_guard lock(m_subscribersMx);
+    m_subscribers.emplace(++m_lastSubscriptionId, std::move(callback));
+    return m_lastSubscriptionId;
+}
+
+void DirectoryMonitor::unsubscribe(SubscriptionId_t subscriptionId)
+{
+    std::lock_guard lock(m_subscribersMx);
+    m_subscribers.erase(subscriptionId);
+}
+
+void DirectoryMonitor::monitorLoop()
+{
+    syncWatches();
+    checkSpace();
+
+    epoll_event events[4];
+    while (!m_isStopping) {
+        auto eventsCount = ::epoll_wait(m_epollFd, events, std::size(events), -1);
+        if (eventsCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            COMPLOG_ERROR("DirectoryMonitor: epoll_wait failed:", std::strerror(errno));
+            return;
+        }
+
+        for (int i = 0; i < eventsCount; ++i) {
+            auto fd = events[i].data.fd;
+            if (fd == m_inotifyFd) {
+                processInotify();
+                continue;
+            }
+
+            // Timer and wake descriptors only need to be drained
+            uint64_t value;
+            [[maybe_unused]] auto res = ::read(fd, &value, sizeof(value));
+            if (m_isStopping) {
+                return;
+            }
+            syncWatches();
+            if (fd == m_timerFd) {
+                checkMissingDirectories();
+                checkSpace();
+            }
+        }
+    }
+}
+
+void DirectoryMonitor::closeDescriptors()
+{
+    for (auto pFd : {&m_epollFd, &m_inotifyFd, &m_timerFd, &m_wakeFd}) {
+        if (*pFd >= 0) {
+            ::close(*pFd);
+            *pFd = -1;
+        }
+    }
+}
+
+void DirectoryMonitor::syncWatches()
+{
+    auto directories = m_dirManager.getDirectories();
+    for (auto watchedIt = m_watched.begin(); watchedIt != m_watched.end(); ) {
+        auto dirIt = directories.find(watchedIt->first);
+        if (dirIt != directories.end() && dirIt->second.lexically_normal() == watchedIt->second.path) {
+            ++watchedIt;
+            continue;
+        }
+        watchedIt = m_watched.erase(watchedIt);
+    }
+
+    for (auto& [dtype, dirPath] : directories) {
+        if (m_watched.count(dtype) != 0) {
+            continue;
+        }
+        auto& watched = m_watched[dtype];
+        watched.path = dirPath.lexically_normal();
+        if (!watched.path.has_filename()) {
+            watched.path = watched.path.parent_path(); // Trailing separator
+        }
+        checkDirectory(dtype, watched, m_options.isRecreatingDirectories);
+    }
+
+    // Watches of parents without watched directories are not needed anymore
+    for (auto parentIt = m_parentWatches.begin(); parentIt != m_parentWatches.end(); ) {
+        auto isUsed = std::any_of(m_watched.begin(), m_watched.end(), [&parentIt](const auto& watchedPair) {
+            return (watchedPair.second.path.parent_path() == parentIt->second);
+        });
+        if (isUsed) {
+            ++parentIt;
+            continue;
+        }
+        ::inotify_rm_watch(m_inotifyFd, parentIt->first);
+        parentIt = m_parentWatches.erase(parentIt);
+    }
+}
+
+void DirectoryMonitor::checkDirectory(int dtype, WatchedDirectory &watched, bool isRecreating)
+{
+    // Parent is watched first, so removal right after check is not lost
+    addParentWatch(watched.path.parent_path());
+
+    struct stat dirStat;
+    auto wasPresent = watched.isPresent;
+    watched.isPresent = (::stat(watched.path.c_str(), &dirStat) == 0 && S_ISDIR(dirStat.st_mode));
+    if (wasPresent && (!watched.isPresent || watched.inode != dirStat.st_ino)) {
+        m_dirManager.resetDirectoryFd(dtype); // Descriptor refers to removed or replaced directory
+    }
+    if (watched.isPresent) {
+        watched.device = dirStat.st_dev;
+        watched.inode = dirStat.st_ino;
+        watched.isMissingReported = false;
+        return;
+    }
+
+    if (!watched.isMissingReported) {
+        watched.isMissingReported = true;
+        publish({DirectoryEvent::Missing, dtype, watched.path});
+    }
+    std::error_code ec;
+    if (!isRecreating || !std::filesystem::create_directories(watched.path, ec)) {
+        return; // Checked again on next poll
+    }
+    m_dirManager.resetDirectoryFd(dtype);
+    COMPLOG_WARNING("DirectoryMonitor: directory recreated:", watched.path.string());
+    publish({DirectoryEvent::Recreated, dtype, watched.path});
+    checkDirectory(dtype, watched, false);
+}
+
+void DirectoryMonitor::checkMissingDirectories()
+{
+    // Inotify event may be missed, if parent was missing too or creation of directory failed
+    for (auto& [dtype, watched] : m_watched) {
+        if (!watched.isPresent) {
+            checkDirectory(dtype, watched, m_options.isRecreatingDirectories);
+        }
+    }
+}
+
+bool DirectoryMonitor::addParentWatch(const std::filesystem::path &parentPath)
+{
+    auto isWatched = std::any_of(m_parentWatches.begin(), m_parentWatches.end(), [&parentPath](const auto& parentPair) {
+        return (parentPair.second == parentPath);
+    });
+    if (isWatched) {
+        return true;
+    }
+
+    auto wd = ::inotify_add_watch(m_inotifyFd, parentPath.c_str(), IN_DELETE | IN_MOVED_FROM | IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+    if (wd < 0) {
+        return false; // Parent is missing too, added when directory is recreated or on next poll
+    }
+    m_parentWatches[wd] = parentPath;
+    return true;
+}
+
+void DirectoryMonitor::processInotify()
+{
+    alignas(inotify_event) char buffer[4096];
+    std::set<int> changedTypes;
+    while (true) {
+        auto readBytes = ::read(m_inotifyFd, buffer, sizeof(buffer));
+        if (readBytes <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < readBytes; ) {
+            auto pEvent = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + pEvent->len;
+
+            auto parentIt = m_parentWatches.find(pEvent->wd);
+            if (parentIt == m_parentWatches.end()) {
+                continue;
+            }
+            if (pEvent->mask & IN_IGNORED) {
+                m_parentWatches.erase(parentIt); // Parent removed, its children were reported before
+                continue;
+            }
+            if (!(pEvent->mask & IN_ISDIR) || pEvent->len == 0) {
+                continue;
+            }
+
+            auto childPath = parentIt->second / pEvent->name;
+            for (auto& [dtype, watched] : m_watched) {
+                if (watched.path == childPath) {
+                    changedTypes.insert(dtype);
+                }
+            }
+        }
+    }
+
+    for (auto dtype : changedTypes) {
+        checkDirectory(dtype, m_watched[dtype], m_options.isRecreatingDirectories);
+    }
+}
+
+void DirectoryMonitor::checkSpace()
+{
+    std::set<dev_t> checkedDevices;
+    for (auto& [dtype, watched] : m_watched) {
+        if (!watched.isPresent || !checkedDevices.insert(watched.device).second) {
+            continue;
+        }
+
+        struct statvfs fsStat;
+        if (::statvfs(watched.path.c_str(), &fsStat) != 0) {
+            continue;
+        }
+        uint64_t availableBytes = uint64_t(fsStat.f_bavail) * fsStat.f_frsize;
+        auto isLowSpace = (availableBytes < m_options.lowSpaceThreshold);
+        auto wasLowSpace = (m_lowSpaceDevices.count(watched.device) != 0);
+        if (isLowSpace == wasLowSpace) {
+            continue;
+        }
+
+        if (isLowSpace) {
+            m_lowSpaceDevices.insert(watched.device);
+            COMPLOG_WARNING("DirectoryMonitor: low disk space:", watched.path.string(), availableBytes);
+        } else {
+            m_lowSpaceDevices.erase(watched.device);
+        }
+        publish({isLowSpace ? DirectoryEvent::LowSpace : DirectoryEvent::SpaceRestored, dtype, watched.path, availableBytes});
+    }
+}
+
+void DirectoryMonitor::publish(const DirectoryEvent &event)
+{
+    std::vector<Callback_t> callbacks;
+    {
+        std::lock_guard lock(m_subscribersMx);
+        for (auto& [subscriptionId, callback] : m_subscribers) {
+            callbacks.push_back(callback);
+        }
+    }
+    for (auto& callback : callbacks) {
+        callback(event);
+    }
+}
+
+} // namespace Common
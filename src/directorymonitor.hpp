@@ -0,0 +1,117 @@
+#pragma once
+
+#include "directorymanager.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The DirectoryEvent struct Event of @ref DirectoryMonitor
+ */
+struct DirectoryEvent
+{
+    enum Type
+    {
+        LowSpace,       // Available space of directory filesystem fell below threshold
+        SpaceRestored,  // Available space is above threshold again
+        Missing,        // Directory does not exist or was removed
+        Recreated,      // Missing directory was created again
+    };
+
+    Type                    type;
+    int                     dtype;
+    std::filesystem::path   path;
+    uint64_t                availableBytes {0}; // For space events
+};
+
+/**
+ * @brief The DirectoryMonitorOptions struct Parameters of @ref DirectoryMonitor
+ */
+struct DirectoryMonitorOptions
+{
+    std::chrono::milliseconds   pollInterval {5000};                // Interval of free space check and directory list refresh
+    uint64_t                    lowSpaceThreshold {512ULL << 20};   // Bytes
+    bool                        isRecreatingDirectories {true};
+};
+
+/**
+ * @brief The DirectoryMonitor class Watches directories of @ref DirectoryManager in one thread
+ * @note Removal of directory is reported by inotify watch of its parent, so directories with common parent
+ *       share one watch. Free space is checked once per filesystem, not per directory.
+ *       Callbacks are called in monitor thread
+ */
+class DirectoryMonitor : public boost::noncopyable
+{
+public:
+    using SubscriptionId_t = uint64_t;
+    using Callback_t = std::function<void(const DirectoryEvent&)>;
+
+    explicit DirectoryMonitor(DirectoryManager& dirManager = DirectoryManager::getInstance());
+    ~DirectoryMonitor();
+
+    /**
+     * @brief start     Start monitor thread
+     * @return          false if already started or epoll/inotify can't be created
+     */
+    bool start(const DirectoryMonitorOptions& options = {});
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief refresh   Update list of watched directories now, without waiting for poll interval
+     */
+    void refresh();
+
+    SubscriptionId_t subscribe(Callback_t&& callback);
+    void unsubscribe(SubscriptionId_t subscriptionId);
+
+private:
+    struct WatchedDirectory
+    {
+        std::filesystem::path   path;
+        bool                    isPresent {false};
+        bool                    isMissingReported {false};  // Missing is published once until directory appears
+        dev_t                   device {0};
+        ino_t                   inode {0};
+    };
+
+    DirectoryManager&               m_dirManager;
+    DirectoryMonitorOptions         m_options;
+    std::thread                     m_monitorThread;
+    int                             m_epollFd {-1};
+    int                             m_inotifyFd {-1};
+    int                             m_timerFd {-1};
+    int                             m_wakeFd {-1};
+    std::atomic<bool>               m_isStopping {false};
+
+    // Accessed only from monitor thread
+    std::map<int, WatchedDirectory>         m_watched;
+    std::map<int, std::filesystem::path>    m_parentWatches;    // Watch descriptor to watched parent directory
+    std::set<dev_t>                         m_lowSpaceDevices;
+
+    std::mutex                          m_subscribersMx;
+    std::map<SubscriptionId_t, Callback_t> m_subscribers;
+    SubscriptionId_t                    m_lastSubscriptionId {0};
+
+    void monitorLoop();
+    void closeDescriptors();
+    void syncWatches();
+    void checkDirectory(int dtype, WatchedDirectory& watched, bool isRecreating);
+    void checkMissingDirectories();
+    bool addParentWatch(const std::filesystem::path& parentPath);
+    void processInotify();
+    void checkSpace();
+    void publish(const DirectoryEvent& event);
+};
+
+} // namespace Common
@@ -0,0 +1,310 @@
+#include "executor.hpp"
+
+#include "applicationsettings.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace Common {
+
+namespace {
+
+constexpr std::size_t   INITIAL_DEQUE_CAPACITY  {256};
+constexpr int           IDLE_SPINS_COUNT        {64};
+
+struct WorkerIdentity
+{
+    const Executor* pExecutor {nullptr};
+    int             index {-1};
+};
+thread_local WorkerIdentity currentWorker;
+
+} // namespace
+
+
+namespace ExecutorDetail {
+
+WorkStealingDeque::WorkStealingDeque()
+{
+    m_buffers.push_back(std::make_unique<Buffer>(INITIAL_DEQUE_CAPACITY));
+    m_pBuffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque()
+{
+
+}
+
+void WorkStealingDeque::push(Task_t *pTask)
+{
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top = m_top.load(std::memory_order_acquire);
+    auto pBuffer = m_pBuffer.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<int64_t>(pBuffer->mask)) {
+        pBuffer = grow(pBuffer, top, bottom);
+    }
+    pBuffer->put(bottom, pTask);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+Task_t *WorkStealingDeque::take()
+{
+    auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto pBuffer = m_pBuffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed); // Empty
+        return nullptr;
+    }
+    auto pTask = pBuffer->get(bottom);
+    if (top == bottom) {
+        // Last task, race with thieves
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            pTask = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return pTask;
+}
+
+Task_t *WorkStealingDeque::steal()
+{
+    auto top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    auto pTask = m_pBuffer.load(std::memory_order_acquire)->get(top);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return pTask;
+}
+
+bool WorkStealingDeque::empty() const
+{
+    return (m_bottom.load(std::memory_order_seq_cst) <= m_top.load(std::memory_order_seq_cst));
+}
+
+WorkStealingDeque::Buffer *WorkStealingDeque::grow(Buffer *pBuffer, int64_t top, int64_t bottom)
+{
+    auto pNewBuffer = std::make_unique<Buffer>((pBuffer->mask + 1) * 2);
+    for (auto i = top; i < bottom; ++i) {
+        pNewBuffer->put(i, pBuffer->get(i));
+    }
+    m_buffers.push_back(std::move(pNewBuffer));
+    m_pBuffer.store(m_buffers.back().get(), std::memory_order_release);
+    return m_buffers.back().get();
+}
+
+} // namespace ExecutorDetail
+
+
+Executor::Executor(const ExecutorOptions &options)
+{
+    auto threadsCount = (options.threadsCount != 0 ? options.threadsCount : std::max(std::thread::hardware_concurrency(), 1u));
+    for (unsigned i = 0; i < threadsCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threadsCount; ++i) {
+        auto& thread = m_workers[i]->thread;
+        thread = std::thread(&Executor::workerLoop, this, i);
+        if (options.cpuAffinity.empty()) {
+            continue;
+        }
+
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(options.cpuAffinity[i % options.cpuAffinity.size()], &cpuSet);
+        if (::pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0) {
+            COMPLOG_WARNING("Executor: failed to set CPU affinity of worker", i);
+        }
+    }
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard lock(m_sleepMx);
+        m_isStopping = true;
+    }
+    m_sleepCv.notify_all();
+    for (auto& pWorker : m_workers) {
+        pWorker->thread.join();
+    }
+
+    // Workers finish all tasks before exit, except posted during stop. These are run here, otherwise their futures
+    // are never ready. Current thread acts as worker without deque, so nested waits run pending tasks too
+    auto prevWorker = currentWorker;
+    currentWorker = {this, -1};
+    while (runPending()) {
+    }
+    currentWorker = prevWorker;
+}
+
+Executor &Executor::getInstance()
+{
+    static Executor inst(readOptions());
+    return inst;
+}
+
+ExecutorOptions Executor::readOptions()
+{
+    ExecutorOptions options;
+    auto& settings = ApplicationSettings::getInstance();
+    if (auto pThreads = settings.getSetting("executor", "threads"); pThreads && pThreads->isSet()) {
+        if (auto pCount = std::get_if<int64_t>(&pThreads->getValueVariant()); pCount && *pCount > 0) {
+            options.threadsCount = static_cast<unsigned>(*pCount);
+        }
+    }
+    if (auto pAffinity = settings.getSetting("executor", "affinity"); pAffinity && pAffinity->isSet()) {
+        auto& affinity = pAffinity->getValueVariant();
+        if (auto pCpu = std::get_if<int64_t>(&affinity); pCpu) {
+            options.cpuAffinity.push_back(static_cast<int>(*pCpu));
+        } else if (auto pCpus = std::get_if<std::vector<int64_t> >(&affinity); pCpus) {
+            options.cpuAffinity.assign(pCpus->begin(), pCpus->end());
+        }
+    }
+    return options;
+}
+
+unsigned Executor::getThreadsCount() const
+{
+    return static_cast<unsigned>(m_workers.size());
+}
+
+bool Executor::isWorkerThread() const
+{
+    return (currentWorker.pExecutor == this);
+}
+
+void Executor::post(ExecutorDetail::Task_t &&task)
+{
+    auto pTask = new ExecutorDetail::Task_t(std::move(task));
+    auto workerIndex = currentWorkerIndex();
+    if (workerIndex >= 0) {
+        m_workers[workerIndex]->deque.push(pTask);
+    } else {
+        std::lock_guard lock(m_injectionMx);
+        m_injectionQueue.push_back(pTask);
+        m_injectionSize.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeWorker();
+}
+
+bool Executor::runPending()
+{
+    auto pTask = findTask(currentWorkerIndex());
+    if (!pTask) {
+        return false;
+    }
+    (*pTask)();
+    delete pTask;
+    return true;
+}
+
+void Executor::workerLoop(unsigned workerIndex)
+{
+    currentWorker = {this, static_cast<int>(workerIndex)};
+    while (true) {
+        ExecutorDetail::Task_t* pTask {nullptr};
+        for (int spin = 0; spin < IDLE_SPINS_COUNT && !pTask; ++spin) {
+            pTask = findTask(workerIndex);
+            if (!pTask && spin != 0) {
+                std::this_thread::yield();
+            }
+        }
+        if (pTask) {
+            (*pTask)();
+            delete pTask;
+            continue;
+        }
+
+        // Sleeping count must be visible before tasks are checked again, see wakeWorker()
+        std::unique_lock lock(m_sleepMx);
+        if (m_isStopping) {
+            break;
+        }
+        auto wakeEpoch = m_wakeEpoch;
+        m_sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        if (!hasVisibleTasks()) {
+            m_sleepCv.wait(lock, [this, wakeEpoch]() {
+                return (m_wakeEpoch != wakeEpoch || m_isStopping);
+            });
+        }
+        m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    currentWorker = {};
+}
+
+ExecutorDetail::Task_t *Executor::findTask(int workerIndex)
+{
+    if (workerIndex >= 0) {
+        if (auto pTask = m_workers[workerIndex]->deque.take(); pTask) {
+            return pTask;
+        }
+    }
+    if (m_injectionSize.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard lock(m_injectionMx);
+        if (!m_injectionQueue.empty()) {
+            auto pTask = m_injectionQueue.front();
+            m_injectionQueue.pop_front();
+            m_injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            return pTask;
+        }
+    }
+
+    auto workersCount = static_cast<int>(m_workers.size());
+    for (int i = 1; i <= workersCount; ++i) {
+        auto victimIndex = (std::max(workerIndex, 0) + i) % workersCount;
+        if (victimIndex == workerIndex) {
+            continue;
+        }
+        if (auto pTask = m_workers[victimIndex]->deque.steal(); pTask) {
+            return pTask;
+        }
+    }
+    return nullptr;
+}
+
+bool Executor::hasVisibleTasks() const
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_injectionSize.load(std::memory_order_seq_cst) != 0) {
+        return true;
+    }
+    for (auto& pWorker : m_workers) {
+        if (!pWorker->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::wakeWorker()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepingCount.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_sleepMx);
+        ++m_wakeEpoch;
+    }
+    m_sleepCv.notify_one();
+}
+
+int Executor::currentWorkerIndex() const
+{
+    return (currentWorker.pExecutor == this ? currentWorker.index : -1);
+}
+
+} // namespace Common
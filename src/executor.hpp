@@ -0,0 +1,330 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace Common {
+
+class Executor;
+
+namespace ExecutorDetail {
+
+using Task_t = std::function<void()>;
+
+/**
+ * @brief The WorkStealingDeque class Chase-Lev deque: owner pushes and takes from bottom, thieves steal from top
+ * @note "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al., 2013
+ */
+class WorkStealingDeque : public boost::noncopyable
+{
+public:
+    WorkStealingDeque();
+    ~WorkStealingDeque();
+
+    void push(Task_t* pTask);       // Owner only
+    Task_t* take();                 // Owner only
+    Task_t* steal();                // Any thread. nullptr if empty or lost race
+    bool empty() const;
+
+private:
+    struct Buffer
+    {
+        explicit Buffer(std::size_t capacity) : mask {capacity - 1}, cells(capacity) {}
+
+        std::size_t                             mask;
+        std::vector<std::atomic<Task_t*> >      cells;
+
+        Task_t* get(int64_t i) const {
+            return cells[i & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, Task_t* pTask) {
+            cells[i & mask].store(pTask, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<int64_t>    m_top {0};
+    alignas(64) std::atomic<int64_t>    m_bottom {0};
+    std::atomic<Buffer*>                m_pBuffer;
+    std::vector<std::unique_ptr<Buffer> > m_buffers;    // Old buffers may still be read by thieves
+
+    Buffer* grow(Buffer* pBuffer, int64_t top, int64_t bottom);
+};
+
+template <typename T>
+using Stored_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/**
+ * @brief The SharedState struct Result of task, shared by promise side and @ref Future
+ */
+template <typename T>
+struct SharedState
+{
+    std::mutex                          mx;
+    std::condition_variable             cv;
+    std::optional<Stored_t<T> >         value;
+    std::exception_ptr                  pException;
+    bool                                isReady {false};
+    std::vector<std::function<void()> > continuations;
+
+    template <typename... Args>
+    void setValue(Args&&... args) {
+        complete([&]() { value.emplace(std::forward<Args>(args)...); });
+    }
+    void setException(std::exception_ptr pEx) {
+        complete([&]() { pException = std::move(pEx); });
+    }
+
+    template <typename F>
+    void onReady(F&& continuation) {
+        {
+            std::lock_guard lock(mx);
+            if (!isReady) {
+                continuations.emplace_back(std::forward<F>(continuation));
+                return;
+            }
+        }
+        continuation();
+    }
+
+private:
+    template <typename F>
+    void complete(F&& store) {
+        std::vector<std::function<void()> > readyContinuations;
+        {
+            std::lock_guard lock(mx);
+            store();
+            isReady = true;
+            readyContinuations.swap(continuations);
+        }
+        cv.notify_all();
+        for (auto& continuation : readyContinuations) {
+            continuation();
+        }
+    }
+};
+
+} // namespace ExecutorDetail
+
+/**
+ * @brief The Future class Result of task, submitted to @ref Executor
+ * @note Waiting in worker thread executes other tasks meanwhile, so nested waits do not deadlock pool
+ */
+template <typename T>
+class Future
+{
+public:
+    Future() = default;
+    Future(std::shared_ptr<ExecutorDetail::SharedState<T> > pState, Executor* pExecutor) :
+        m_pState {std::move(pState)},
+        m_pExecutor {pExecutor}
+    {}
+
+    bool isValid() const {
+        return (m_pState != nullptr);
+    }
+    bool isReady() const {
+        std::lock_guard lock(m_pState->mx);
+        return m_pState->isReady;
+    }
+
+    void wait() const;
+
+    /**
+     * @brief get   Wait for result
+     * @return      Result of task
+     * @throws      Exception, thrown by task
+     */
+    T get() const {
+        wait();
+        if (m_pState->pException) {
+            std::rethrow_exception(m_pState->pException);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return *m_pState->value;
+        }
+    }
+
+    /**
+     * @brief then          Run continuation in executor when result is ready
+     * @param continuation  Callable, receiving result (nothing for Future<void>). Not called if task has thrown,
+     *                      exception is passed to returned future instead
+     * @return              Future of continuation result
+     */
+    template <typename F>
+    auto then(F&& continuation);
+
+private:
+    std::shared_ptr<ExecutorDetail::SharedState<T> >    m_pState;
+    Executor*                                           m_pExecutor {nullptr};
+};
+
+/**
+ * @brief The ExecutorOptions struct Parameters of @ref Executor
+ */
+struct ExecutorOptions
+{
+    unsigned            threadsCount {0};   // 0 - std::thread::hardware_concurrency()
+    std::vector<int>    cpuAffinity;        // Worker i is bound to cpuAffinity[i % size]. Empty - not bound
+};
+
+/**
+ * @brief The Executor class Work-stealing thread pool
+ * @note Task, submitted from worker, is pushed to its own deque and taken in LIFO order.
+ *       Task from other thread is pushed to global queue. Idle workers steal from other deques
+ */
+class Executor : public boost::noncopyable
+{
+public:
+    explicit Executor(const ExecutorOptions& options = {});
+
+    /**
+     * @brief ~Executor Stop workers. Tasks, posted during stop, are run in current thread
+     */
+    ~Executor();
+
+    /**
+     * @brief getInstance   Shared executor of Common. Configured by ApplicationSettings on first call:
+     *                      [executor] threads=<count>, affinity=<cpu>,<cpu>,...
+     */
+    static Executor& getInstance();
+
+    /**
+     * @brief readOptions   Read executor options from ApplicationSettings section "executor"
+     */
+    static ExecutorOptions readOptions();
+
+    unsigned getThreadsCount() const;
+
+    /**
+     * @brief isWorkerThread    Check if current thread is worker of this executor
+     */
+    bool isWorkerThread() const;
+
+    /**
+     * @brief post  Run task without result
+     */
+    void post(ExecutorDetail::Task_t&& task);
+
+    /**
+     * @brief submit    Run task
+     * @return          Future of task result
+     */
+    template <typename F>
+    auto submit(F&& task) {
+        using Result_t = std::invoke_result_t<std::decay_t<F> >;
+        auto pState = std::make_shared<ExecutorDetail::SharedState<Result_t> >();
+        post([pState, task = std::forward<F>(task)]() mutable {
+            try {
+                if constexpr (std::is_void_v<Result_t>) {
+                    task();
+                    pState->setValue();
+                } else {
+                    pState->setValue(task());
+                }
+            } catch (...) {
+                pState->setException(std::current_exception());
+            }
+        });
+        return Future<Result_t>(std::move(pState), this);
+    }
+
+    /**
+     * @brief runPending    Run one pending task in current thread
+     * @return              false if there was no task
+     */
+    bool runPending();
+
+private:
+    struct Worker
+    {
+        ExecutorDetail::WorkStealingDeque   deque;
+        std::thread                         thread;
+    };
+
+    std::vector<std::unique_ptr<Worker> >   m_workers;
+    std::mutex                              m_injectionMx;
+    std::deque<ExecutorDetail::Task_t*>     m_injectionQueue;
+    std::atomic<std::size_t>                m_injectionSize {0};
+
+    // Sleeping of idle workers
+    std::mutex                              m_sleepMx;
+    std::condition_variable                 m_sleepCv;
+    std::atomic<unsigned>                   m_sleepingCount {0};
+    uint64_t                                m_wakeEpoch {0};
+    bool                                    m_isStopping {false};
+
+    void workerLoop(unsigned workerIndex);
+    ExecutorDetail::Task_t* findTask(int workerIndex);
+    bool hasVisibleTasks() const;
+    void wakeWorker();
+    int currentWorkerIndex() const;
+};
+
+
+template <typename T>
+void Future<T>::wait() const
+{
+    if (m_pExecutor && m_pExecutor->isWorkerThread()) {
+        while (!isReady()) {
+            if (!m_pExecutor->runPending()) {
+                std::this_thread::yield();
+            }
+        }
+        return;
+    }
+    std::unique_lock lock(m_pState->mx);
+    m_pState->cv.wait(lock, [this]() { return m_pState->isReady; });
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::then(F&& continuation)
+{
+    using Result_t = std::conditional_t<std::is_void_v<T>, std::invoke_result<std::decay_t<F> >,
+                                        std::invoke_result<std::decay_t<F>, T> >;
+    using ContinuationResult_t = typename Result_t::type;
+
+    auto pNextState = std::make_shared<ExecutorDetail::SharedState<ContinuationResult_t> >();
+    auto pExecutor = m_pExecutor;
+    auto pState = m_pState;
+    m_pState->onReady([pExecutor, pState, pNextState, continuation = std::forward<F>(continuation)]() mutable {
+        pExecutor->post([pState, pNextState, continuation = std::move(continuation)]() mutable {
+            if (pState->pException) {
+                pNextState->setException(pState->pException);
+                return;
+            }
+            try {
+                auto invoke = [&]() -> decltype(auto) {
+                    if constexpr (std::is_void_v<T>) {
+                        return continuation();
+                    } else {
+                        return continuation(*pState->value);
+                    }
+                };
+                if constexpr (std::is_void_v<ContinuationResult_t>) {
+                    invoke();
+                    pNextState->setValue();
+                } else {
+                    pNextState->setValue(invoke());
+                }
+            } catch (...) {
+                pNextState->setException(std::current_exception());
+            }
+        });
+    });
+    return Future<ContinuationResult_t>(std::move(pNextState), m_pExecutor);
+}
+
+} // namespace Common
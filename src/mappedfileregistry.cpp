@@ -0,0 +1,212 @@
+#include "mappedfileregistry.hpp"
+
+#include "executor.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Common {
+
+MappedFile::MappedFile(void *pData, std::size_t size) :
+    m_pData {pData},
+    m_size {size}
+{
+
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_pData) {
+        ::munmap(m_pData, m_size);
+    }
+}
+
+ByteView_t MappedFile::getData() const
+{
+    return ByteView_t(static_cast<const std::byte*>(m_pData), m_size);
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+
+
+bool MappedFileRegistry::FileIdentity::operator==(const FileIdentity &other) const
+{
+    return (device == other.device && inode == other.inode && size == other.size && modificationNs == other.modificationNs);
+}
+
+MappedFileRegistry::MappedFileRegistry(DirectoryManager &dirManager) :
+    m_dirManager {dirManager}
+{
+
+}
+
+MappedFileRegistry::~MappedFileRegistry()
+{
+    waitPrefetch();
+}
+
+MappedFileRegistry &MappedFileRegistry::getInstance()
+{
+    static MappedFileRegistry inst;
+    return inst;
+}
+
+MappedFilePtr MappedFileRegistry::map(int dtype, const std::filesystem::path &relPath, const MappingOptions &options)
+{
+    struct stat fileStat;
+    if (!m_dirManager.statFile(dtype, relPath, fileStat)) {
+        COMPLOG_ERROR("MappedFileRegistry: file not found:", relPath.string(), std::strerror(errno));
+        return nullptr;
+    }
+
+    Key_t key {dtype, relPath.lexically_normal().string()};
+    auto identity = getIdentity(fileStat);
+    {
+        std::lock_guard lock(m_entriesMx);
+        auto entryIt = m_entries.find(key);
+        if (entryIt != m_entries.end() && entryIt->second.identity == identity) {
+            if (auto pMapping = entryIt->second.pMapping.lock(); pMapping) {
+                applyHints(*pMapping, options.access);
+                return pMapping;
+            }
+        }
+    }
+
+    // Mapped without lock. Identity is taken from opened descriptor, file may be replaced after fstatat
+    auto pMapping = createMapping(dtype, relPath, options, identity);
+    if (!pMapping) {
+        return nullptr;
+    }
+    {
+        std::lock_guard lock(m_entriesMx);
+        auto& entry = m_entries[key];
+        if (auto pOtherMapping = entry.pMapping.lock(); pOtherMapping && entry.identity == identity) {
+            return pOtherMapping; // Mapped concurrently by other thread
+        }
+        entry = {identity, pMapping};
+
+        // Entries of released mappings are dropped here, so registry does not grow with files, used once
+        for (auto entryIt = m_entries.begin(); entryIt != m_entries.end(); ) {
+            entryIt = (entryIt->second.pMapping.expired() ? m_entries.erase(entryIt) : std::next(entryIt));
+        }
+    }
+    if (options.prefetch == MappingPrefetch::Background) {
+        startPrefetch(pMapping);
+    }
+    return pMapping;
+}
+
+std::size_t MappedFileRegistry::getMappingsCount() const
+{
+    std::lock_guard lock(m_entriesMx);
+    std::size_t res {0};
+    for (auto& [key, entry] : m_entries) {
+        res += (entry.pMapping.expired() ? 0 : 1);
+    }
+    return res;
+}
+
+void MappedFileRegistry::waitPrefetch()
+{
+    std::unique_lock lock(m_prefetchMx);
+    m_prefetchCv.wait(lock, [this]() {
+        return (m_prefetchCount == 0);
+    });
+}
+
+MappedFileRegistry::FileIdentity MappedFileRegistry::getIdentity(const struct stat &fileStat)
+{
+    return {fileStat.st_dev, fileStat.st_ino, fileStat.st_size,
+            int64_t(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec};
+}
+
+void MappedFileRegistry::applyHints(const MappedFile &mapping, MappingAccess access)
+{
+    if (access == MappingAccess::Normal || mapping.getSize() == 0) {
+        return;
+    }
+    int advice = (access == MappingAccess::Sequential ? MADV_SEQUENTIAL :
+                 (access == MappingAccess::Random ? MADV_RANDOM : MADV_WILLNEED));
+    if (::madvise(mapping.m_pData, mapping.m_size, advice) != 0) {
+        COMPLOG_WARNING("MappedFileRegistry: madvise failed:", std::strerror(errno));
+    }
+}
+
+MappedFilePtr MappedFileRegistry::createMapping(int dtype, const std::filesystem::path &relPath, const MappingOptions &options, FileIdentity &identity)
+{
+    int fd = m_dirManager.openFile(dtype, relPath, O_RDONLY);
+    if (fd < 0) {
+        COMPLOG_ERROR("MappedFileRegistry: failed to open file:", relPath.string(), std::strerror(errno));
+        return nullptr;
+    }
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        COMPLOG_ERROR("MappedFileRegistry: failed to stat file:", relPath.string(), std::strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+    identity = getIdentity(fileStat);
+
+    void* pData {nullptr};
+    auto size = static_cast<std::size_t>(fileStat.st_size);
+    if (size != 0) {
+        int flags = MAP_PRIVATE | (options.prefetch == MappingPrefetch::Synchronous ? MAP_POPULATE : 0);
+        pData = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    }
+    ::close(fd); // Mapping keeps file referenced
+    if (pData == MAP_FAILED) {
+        COMPLOG_ERROR("MappedFileRegistry: failed to map file:", relPath.string(), std::strerror(errno));
+        return nullptr;
+    }
+
+    MappedFilePtr pMapping(new MappedFile(pData, size));
+    applyHints(*pMapping, options.access);
+    return pMapping;
+}
+
+void MappedFileRegistry::startPrefetch(const MappedFilePtr &pMapping)
+{
+    {
+        std::lock_guard lock(m_prefetchMx);
+        ++m_prefetchCount;
+    }
+    // Registry is not destroyed before task finishes, see destructor
+    Executor::getInstance().post([this, pMapping]() {
+        prefetch(*pMapping);
+        std::lock_guard lock(m_prefetchMx);
+        --m_prefetchCount;
+        m_prefetchCv.notify_all();
+    });
+}
+
+void MappedFileRegistry::prefetch(const MappedFile &mapping)
+{
+    auto data = mapping.getData();
+    if (data.empty()) {
+        return;
+    }
+#ifdef MADV_POPULATE_READ
+    if (::madvise(const_cast<std::byte*>(data.data()), data.size(), MADV_POPULATE_READ) == 0) {
+        return;
+    }
+#endif // MADV_POPULATE_READ
+
+    // Kernel before 5.14: page faults by reading one byte of each page
+    auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    volatile std::byte sink {};
+    for (std::size_t offset = 0; offset < data.size(); offset += pageSize) {
+        sink = data[offset];
+    }
+    (void)sink;
+}
+
+} // namespace Common
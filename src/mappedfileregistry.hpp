@@ -0,0 +1,137 @@
+#pragma once
+
+#include "directorymanager.hpp"
+#include "appsettings/appsettingscommon.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Common {
+
+using ByteView_t = ArrayView_t<std::byte>;
+
+/**
+ * @brief The MappingAccess enum Expected access pattern, passed to madvise(2)
+ */
+enum class MappingAccess
+{
+    Normal,
+    Sequential,
+    Random,
+    WillNeed,   // Start readahead of whole file now
+};
+
+/**
+ * @brief The MappingPrefetch enum Loading of file pages on mapping
+ */
+enum class MappingPrefetch
+{
+    None,           // Pages are loaded on first access
+    Synchronous,    // MAP_POPULATE, map() returns when file is loaded
+    Background,     // Pages are loaded by task of Executor::getInstance(), map() returns immediately
+};
+
+struct MappingOptions
+{
+    MappingAccess   access {MappingAccess::Normal};
+    MappingPrefetch prefetch {MappingPrefetch::None};
+};
+
+/**
+ * @brief The MappedFile class Read-only mapping of file. Unmapped when last reference is released
+ * @note Mapping keeps contents of file it was created for, if file is replaced by rename (@ref AtomicFileWriter)
+ *       or removed later. Mapping is MAP_PRIVATE, but pages, not copied yet, are shared with file:
+ *       in-place write to file is visible through mapping, and access beyond end of truncated file raises SIGBUS.
+ *       Mapped files must be changed by replace only
+ */
+class MappedFile : public boost::noncopyable
+{
+public:
+    ~MappedFile();
+
+    ByteView_t getData() const;
+    std::size_t getSize() const;
+
+private:
+    friend class MappedFileRegistry;
+    MappedFile(void* pData, std::size_t size);
+
+    void*       m_pData;
+    std::size_t m_size;
+};
+
+using MappedFilePtr = std::shared_ptr<const MappedFile>;
+
+/**
+ * @brief The MappedFileRegistry class Shares read-only mappings of files in directories of @ref DirectoryManager
+ * @note Registry keeps weak references, so mapping lives while somebody uses it.
+ *       Every map() checks file by fstatat(2) relative to cached directory descriptor, and file,
+ *       replaced since last mapping (e.g. by @ref AtomicFileWriter), is mapped again
+ */
+class MappedFileRegistry : public boost::noncopyable
+{
+public:
+    explicit MappedFileRegistry(DirectoryManager& dirManager = DirectoryManager::getInstance());
+    ~MappedFileRegistry();
+
+    static MappedFileRegistry& getInstance();
+
+    /**
+     * @brief map       Get mapping of current version of file
+     * @param dtype     @ref DirectoryType enum or custom value, DirectoryType::Data usually
+     * @param relPath   Path relative to directory
+     * @param options   Hints. Hints of shared mapping are applied again on each call
+     * @return          nullptr if file can't be opened or mapped
+     */
+    MappedFilePtr map(int dtype, const std::filesystem::path& relPath, const MappingOptions& options = {});
+
+    /**
+     * @brief getMappingsCount  Count of mappings, referenced by callers
+     */
+    std::size_t getMappingsCount() const;
+
+    /**
+     * @brief waitPrefetch  Wait for background prefetch to finish
+     */
+    void waitPrefetch();
+
+private:
+    struct FileIdentity
+    {
+        dev_t       device {0};
+        ino_t       inode {0};
+        off_t       size {0};
+        int64_t     modificationNs {0};
+
+        bool operator==(const FileIdentity& other) const;
+    };
+    struct Entry
+    {
+        FileIdentity                    identity;
+        std::weak_ptr<const MappedFile> pMapping;
+    };
+    using Key_t = std::pair<int, std::string>;
+
+    DirectoryManager&           m_dirManager;
+    mutable std::mutex          m_entriesMx;
+    std::map<Key_t, Entry>      m_entries;
+
+    std::mutex                  m_prefetchMx;
+    std::condition_variable     m_prefetchCv;
+    std::size_t                 m_prefetchCount {0};    // Posted and not finished prefetch tasks
+
+    static FileIdentity getIdentity(const struct stat& fileStat);
+    static void applyHints(const MappedFile& mapping, MappingAccess access);
+    MappedFilePtr createMapping(int dtype, const std::filesystem::path& relPath, const MappingOptions& options, FileIdentity& identity);
+    void startPrefetch(const MappedFilePtr& pMapping);
+    static void prefetch(const MappedFile& mapping);
+};
+
+} // namespace Common
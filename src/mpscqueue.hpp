@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace Common {
+
+/**
+ * @brief The MpscQueue class Unbounded lock-free queue for many producers and one consumer
+ * @note Node-based queue with stub node (D. Vyukov). push() is wait-free, pop() must be called from one thread only.
+ *       pop() may report empty queue while producer is inside push(), element will be available right after it
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() :
+        m_pHead {new Node},
+        m_pTail {m_pHead.load(std::memory_order_relaxed)}
+    {
+
+    }
+
+    ~MpscQueue() {
+        while (pop()) {}
+        delete m_pTail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        auto pNode = new Node;
+        pNode->value.emplace(std::move(value));
+        auto pPrev = m_pHead.exchange(pNode, std::memory_order_acq_rel);
+        pPrev->pNext.store(pNode, std::memory_order_release);
+    }
+
+    std::optional<T> pop() {
+        auto pNext = m_pTail->pNext.load(std::memory_order_acquire);
+        if (!pNext) {
+            return std::nullopt;
+        }
+        // Next node becomes new stub, value is moved out of it
+        std::optional<T> res(std::move(pNext->value));
+        pNext->value.reset();
+        delete m_pTail;
+        m_pTail = pNext;
+        return res;
+    }
+
+    bool empty() const {
+        return (m_pTail->pNext.load(std::memory_order_acquire) == nullptr);
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*>  pNext {nullptr};
+        std::optional<T>    value;
+    };
+
+    std::atomic<Node*>  m_pHead;    // Producers side
+    Node*               m_pTail;    // Consumer side
+};
+
+} // namespace Common
@@ -0,0 +1,256 @@
+#include "pluginregistry.hpp"
+
+#include "executor.hpp"
+#include "utility.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <link.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+constexpr const char*   MANIFEST_SUFFIX         {".plugin"};
+constexpr const char*   METADATA_SECTION        {".common_plugin"};
+constexpr std::size_t   MAX_METADATA_SIZE       {64 * 1024};
+
+bool isSharedObject(const std::filesystem::path& filePath) {
+    auto fileName = filePath.filename().string();
+    return (filePath.extension() == ".so" || fileName.find(".so.") != std::string::npos);
+}
+
+void parseMetadata(std::string_view text, std::map<std::string, std::string>& res) {
+    std::istringstream input {std::string(text)};
+    std::string line;
+    while (std::getline(input, line)) {
+        auto separatorPos = line.find('=');
+        if (separatorPos == std::string::npos) {
+            continue;
+        }
+        res[line.substr(0, separatorPos)] = line.substr(separatorPos + 1);
+    }
+}
+
+bool readExact(int fd, void* pData, std::size_t size, off_t offset) {
+    return (::pread(fd, pData, size, offset) == static_cast<ssize_t>(size));
+}
+
+/**
+ * @brief readElfMetadata   Read metadata section from section headers of shared object, without loading it
+ */
+bool readElfMetadata(const std::filesystem::path& filePath, std::string& res) {
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    auto readSection = [fd, &res]() {
+        ElfW(Ehdr) header;
+        if (!readExact(fd, &header, sizeof(header), 0) ||
+            std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 ||
+            header.e_shentsize != sizeof(ElfW(Shdr)) ||
+            header.e_shstrndx >= header.e_shnum) {
+            return false;
+        }
+        std::vector<ElfW(Shdr)> sections(header.e_shnum);
+        if (!readExact(fd, sections.data(), sections.size() * sizeof(ElfW(Shdr)), header.e_shoff)) {
+            return false;
+        }
+        auto& namesSection = sections[header.e_shstrndx];
+        std::string names(std::min<std::size_t>(namesSection.sh_size, MAX_METADATA_SIZE), '\0');
+        if (!readExact(fd, names.data(), names.size(), namesSection.sh_offset)) {
+            return false;
+        }
+
+        for (auto& section : sections) {
+            if (section.sh_name >= names.size() || std::strcmp(names.c_str() + section.sh_name, METADATA_SECTION) != 0) {
+                continue;
+            }
+            res.resize(std::min<std::size_t>(section.sh_size, MAX_METADATA_SIZE));
+            if (!readExact(fd, res.data(), res.size(), section.sh_offset)) {
+                return false;
+            }
+            res.resize(std::strlen(res.c_str()));
+            return true;
+        }
+        return false;
+    };
+    auto isFound = readSection();
+    ::close(fd);
+    return isFound;
+}
+
+} // namespace
+
+
+PluginRegistry::PluginRegistry(DirectoryManager &dirManager) :
+    m_dirManager {dirManager}
+{
+
+}
+
+PluginRegistry::~PluginRegistry()
+{
+    waitPrewarm();
+}
+
+PluginRegistry &PluginRegistry::getInstance()
+{
+    static PluginRegistry inst;
+    return inst;
+}
+
+bool PluginRegistry::scan(unsigned workersCount)
+{
+    auto& pluginsPath = m_dirManager.getDirectory(DirectoryType::Plugins);
+    std::error_code ec;
+    std::vector<std::filesystem::path> files;
+    for (auto& dirEntry : std::filesystem::directory_iterator(pluginsPath, ec)) {
+        if (dirEntry.is_regular_file() && isSharedObject(dirEntry.path())) {
+            files.push_back(dirEntry.path());
+        }
+    }
+    if (pluginsPath.empty() || ec) {
+        COMPLOG_ERROR("PluginRegistry: failed to read plugins directory:", pluginsPath.string(), ec.message());
+        return false;
+    }
+
+    // Only metadata is read here, without dlopen, so cost does not depend on plugin size and dependencies
+    std::vector<std::unique_ptr<PluginEntry> > foundEntries(files.size());
+    forEachParallel(files.size(), workersCount, [&](std::size_t i) {
+        auto pEntry = std::make_unique<PluginEntry>();
+        pEntry->info.path = files[i];
+
+        std::ifstream manifest(files[i].string() + MANIFEST_SUFFIX);
+        if (manifest.is_open()) {
+            std::string text((std::istreambuf_iterator<char>(manifest)), std::istreambuf_iterator<char>());
+            parseMetadata(text, pEntry->info.metadata);
+        } else if (std::string text; readElfMetadata(files[i], text)) {
+            parseMetadata(text, pEntry->info.metadata);
+        }
+
+        if (auto nameIt = pEntry->info.metadata.find("name"); nameIt != pEntry->info.metadata.end()) {
+            pEntry->info.name = nameIt->second;
+        } else {
+            // "libexporter.so.1" -> "exporter"
+            auto fileName = files[i].filename().string();
+            fileName.erase(fileName.find(".so"));
+            pEntry->info.name = (fileName.rfind("lib", 0) == 0 ? fileName.substr(3) : fileName);
+        }
+        foundEntries[i] = std::move(pEntry);
+        return true;
+    });
+
+    std::unique_lock lock(m_pluginsMx);
+    for (auto& pEntry : foundEntries) {
+        auto pluginName = pEntry->info.name;
+        if (m_plugins.count(pluginName) != 0) {
+            continue; // Already known, may be loaded
+        }
+        m_plugins.emplace(std::move(pluginName), std::move(pEntry));
+    }
+    COMPLOG_INFO("PluginRegistry: plugins found:", m_plugins.size());
+    return true;
+}
+
+std::vector<std::string> PluginRegistry::getPluginNames() const
+{
+    std::shared_lock lock(m_pluginsMx);
+    std::vector<std::string> res;
+    res.reserve(m_plugins.size());
+    for (auto& [pluginName, pEntry] : m_plugins) {
+        res.push_back(pluginName);
+    }
+    return res;
+}
+
+const PluginInfo *PluginRegistry::getPluginInfo(const std::string &pluginName) const
+{
+    auto pEntry = findEntry(pluginName);
+    return (pEntry ? &pEntry->info : nullptr);
+}
+
+void *PluginRegistry::getSymbol(const std::string &pluginName, const std::string &symbolName)
+{
+    auto pEntry = findEntry(pluginName);
+    if (!pEntry || !loadEntry(*pEntry)) {
+        return nullptr;
+    }
+    auto pSymbol = ::dlsym(pEntry->pHandle.load(std::memory_order_acquire), symbolName.c_str());
+    if (!pSymbol) {
+        COMPLOG_ERROR("PluginRegistry: symbol not found:", pluginName, symbolName);
+    }
+    return pSymbol;
+}
+
+bool PluginRegistry::load(const std::string &pluginName)
+{
+    auto pEntry = findEntry(pluginName);
+    return (pEntry && loadEntry(*pEntry));
+}
+
+bool PluginRegistry::isLoaded(const std::string &pluginName) const
+{
+    auto pEntry = findEntry(pluginName);
+    return (pEntry && pEntry->pHandle.load(std::memory_order_acquire) != nullptr);
+}
+
+void PluginRegistry::prewarm(const std::vector<std::string> &pluginNames)
+{
+    {
+        std::lock_guard lock(m_prewarmMx);
+        ++m_prewarmCount;
+    }
+    // Registry is not destroyed before task finishes, see destructor
+    Executor::getInstance().post([this, pluginNames]() {
+        for (auto& pluginName : (pluginNames.empty() ? getPluginNames() : pluginNames)) {
+            load(pluginName);
+        }
+        std::lock_guard lock(m_prewarmMx);
+        --m_prewarmCount;
+        m_prewarmCv.notify_all();
+    });
+}
+
+void PluginRegistry::waitPrewarm()
+{
+    std::unique_lock lock(m_prewarmMx);
+    m_prewarmCv.wait(lock, [this]() {
+        return (m_prewarmCount == 0);
+    });
+}
+
+PluginRegistry::PluginEntry *PluginRegistry::findEntry(const std::string &pluginName) const
+{
+    std::shared_lock lock(m_pluginsMx);
+    auto pluginIt = m_plugins.find(pluginName);
+    if (pluginIt == m_plugins.end()) {
+        COMPLOG_ERROR("PluginRegistry: plugin not found:", pluginName);
+        return nullptr;
+    }
+    return pluginIt->second.get();
+}
+
+bool PluginRegistry::loadEntry(PluginEntry &entry)
+{
+    std::call_once(entry.loadFlag, [&entry]() {
+        auto pHandle = ::dlopen(entry.info.path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!pHandle) {
+            COMPLOG_ERROR("PluginRegistry: failed to load plugin:", entry.info.name, ::dlerror());
+            return;
+        }
+        entry.pHandle.store(pHandle, std::memory_order_release);
+        COMPLOG_INFO("PluginRegistry: plugin loaded:", entry.info.name);
+    });
+    return (entry.pHandle.load(std::memory_order_acquire) != nullptr);
+}
+
+} // namespace Common
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "directorymanager.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief COMMON_PLUGIN_METADATA Embed plugin metadata ("key=value" lines) into ELF section of plugin,
+ *                               so it can be read by @ref Common::PluginRegistry without loading plugin
+ * @example COMMON_PLUGIN_METADATA("name=exporter\nversion=1.2\n")
+ */
+#define COMMON_PLUGIN_METADATA(text) \
+    extern "C" __attribute__((section(".common_plugin"), used)) const char commonPluginMetadata[] = text
+
+namespace Common {
+
+/**
+ * @brief The PluginInfo struct Plugin, found in plugins directory
+ */
+struct PluginInfo
+{
+    std::string                         name;       // "name" from metadata or file name
+    std::filesystem::path               path;
+    std::map<std::string, std::string>  metadata;
+};
+
+/**
+ * @brief The PluginRegistry class Plugins of DirectoryType::Plugins directory, loaded on first use
+ * @note Metadata is read from "<file>.plugin" manifest near shared object or from ".common_plugin" ELF section
+ *       (see @ref COMMON_PLUGIN_METADATA). Plugins are never unloaded
+ */
+class PluginRegistry : public boost::noncopyable
+{
+public:
+    PluginRegistry(DirectoryManager& dirManager = DirectoryManager::getInstance());
+    ~PluginRegistry();
+
+    static PluginRegistry& getInstance();
+
+    /**
+     * @brief scan          Find new plugins in plugins directory. Files are read in parallel
+     * @param workersCount  Count of threads to read metadata
+     * @return              false if directory can not be read
+     */
+    bool scan(unsigned workersCount = std::thread::hardware_concurrency());
+
+    std::vector<std::string> getPluginNames() const;
+    const PluginInfo* getPluginInfo(const std::string& pluginName) const;
+
+    /**
+     * @brief getSymbol     Get symbol of plugin, loading plugin if not loaded yet
+     * @return              Symbol address or nullptr if plugin or symbol not found
+     */
+    void* getSymbol(const std::string& pluginName, const std::string& symbolName);
+
+    template <typename FunctionT>
+    FunctionT* getFunction(const std::string& pluginName, const std::string& symbolName) {
+        return reinterpret_cast<FunctionT*>(getSymbol(pluginName, symbolName));
+    }
+
+    /**
+     * @brief load  Load plugin, if not loaded yet
+     * @return      false if plugin not found or can't be loaded
+     */
+    bool load(const std::string& pluginName);
+    bool isLoaded(const std::string& pluginName) const;
+
+    /**
+     * @brief prewarm       Load plugins by task of Executor::getInstance()
+     * @param pluginNames   Plugins to load, all found if empty
+     */
+    void prewarm(const std::vector<std::string>& pluginNames = {});
+
+    /**
+     * @brief waitPrewarm   Wait for background loading to finish
+     */
+    void waitPrewarm();
+
+private:
+    struct PluginEntry
+    {
+        PluginInfo          info;
+        std::once_flag      loadFlag;
+        std::atomic<void*>  pHandle {nullptr};
+    };
+
+    DirectoryManager&                                   m_dirManager;
+    mutable std::shared_mutex                           m_pluginsMx;
+    std::map<std::string, std::unique_ptr<PluginEntry> > m_plugins;
+    std::mutex                                          m_prewarmMx;
+    std::condition_variable                             m_prewarmCv;
+    std::size_t                                         m_prewarmCount {0};     // Posted and not finished prewarm tasks
+
+    PluginEntry* findEntry(const std::string& pluginName) const;
+    bool loadEntry(PluginEntry& entry);
+};
+
+} // namespace Common
@@ -0,0 +1,649 @@
+#include "settingsitemmodel.hpp"
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+
+#include "executor.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <numeric>
+
+namespace Common {
+
+namespace {
+
+// Rows of section, exposed to view at once. Others are exposed by fetchMore() while scrolling
+constexpr int FETCH_CHUNK_SIZE {2000};
+
+void appendLower(std::string& output, std::string_view text) {
+    for (auto ch : text) {
+        output += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+}
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+} // namespace
+
+
+struct SettingsItemModel::NotifierGuard
+{
+    std::mutex          mx;
+    SettingsItemModel*  pModel {nullptr};
+};
+
+
+SettingsItemModel::SettingsItemModel(ApplicationSettings &settings, QObject *pParent) :
+    QAbstractItemModel(pParent),
+    m_settings {settings},
+    m_pNotifierGuard {std::make_shared<NotifierGuard>()}
+{
+    // Subscribed before reading settings, so no change is lost. Changes are looked up again when applied
+    m_pNotifierGuard->pModel = this;
+    m_subscriptionId = m_settings.getNotifier().subscribe("**", [pGuard = m_pNotifierGuard](const std::vector<SettingChange>& changes) {
+        std::lock_guard lock(pGuard->mx);
+        if (!pGuard->pModel) {
+            return;
+        }
+        auto pModel = pGuard->pModel;
+        QMetaObject::invokeMethod(pModel, [pModel, changes]() {
+            pModel->applyChanges(changes);
+        }, Qt::QueuedConnection);
+    });
+    buildSections();
+}
+
+SettingsItemModel::~SettingsItemModel()
+{
+    m_settings.getNotifier().unsubscribe(m_subscriptionId);
+    {
+        std::lock_guard lock(m_pNotifierGuard->mx);
+        m_pNotifierGuard->pModel = nullptr;
+    }
+
+    // Results of finished jobs are posted to this object and dropped by Qt together with it
+    std::unique_lock lock(m_jobsMx);
+    m_jobsCv.wait(lock, [this]() { return (m_runningJobsCount == 0); });
+}
+
+QModelIndex SettingsItemModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnsCount) {
+        return {};
+    }
+    if (!parent.isValid()) {
+        return (row < static_cast<int>(m_visibleSections.size()) ? createIndex(row, column, quintptr(0)) : QModelIndex());
+    }
+    if (parent.internalId() != 0 || parent.row() >= static_cast<int>(m_visibleSections.size())) {
+        return {};
+    }
+    auto sectionId = m_visibleSections[parent.row()];
+    if (row >= m_sections[sectionId].fetchedCount) {
+        return {};
+    }
+    return createIndex(row, column, quintptr(sectionId + 1));
+}
+
+QModelIndex SettingsItemModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0) {
+        return {};
+    }
+    auto sectionRow = findVisibleSectionRow(static_cast<uint32_t>(child.internalId() - 1));
+    return (sectionRow >= 0 ? createIndex(sectionRow, 0, quintptr(0)) : QModelIndex());
+}
+
+int SettingsItemModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return static_cast<int>(m_visibleSections.size());
+    }
+    if (parent.internalId() != 0 || parent.column() != 0 || parent.row() >= static_cast<int>(m_visibleSections.size())) {
+        return 0;
+    }
+    return m_sections[m_visibleSections[parent.row()]].fetchedCount;
+}
+
+int SettingsItemModel::columnCount(const QModelIndex &) const
+{
+    return ColumnsCount;
+}
+
+bool SettingsItemModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return !m_visibleSections.empty();
+    }
+    return (parent.internalId() == 0 && parent.column() == 0 && parent.row() < static_cast<int>(m_visibleSections.size()));
+}
+
+QVariant SettingsItemModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole)) {
+        return {};
+    }
+    if (index.internalId() == 0) {
+        if (index.column() != NameColumn || index.row() >= static_cast<int>(m_visibleSections.size())) {
+            return {};
+        }
+        return QString::fromStdString(m_sections[m_visibleSections[index.row()]].name);
+    }
+
+    auto pSetting = getSetting(index);
+    if (!pSetting) {
+        return {};
+    }
+    if (role == Qt::ToolTipRole) {
+        return toQString(pSetting->getDescription());
+    }
+    switch (index.column()) {
+    case NameColumn:
+        return toQString(pSetting->getName());
+    case ValueColumn:
+        return QString::fromStdString(pSetting->getValueString());
+    case SourceColumn:
+        return QString::fromStdString(m_settings.getSettingSource(m_sections[index.internalId() - 1].name,
+                                                                  std::string(pSetting->getName())));
+    }
+    return {};
+}
+
+QVariant SettingsItemModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+    switch (section) {
+    case NameColumn:    return QStringLiteral("Name");
+    case ValueColumn:   return QStringLiteral("Value");
+    case SourceColumn:  return QStringLiteral("Source");
+    }
+    return {};
+}
+
+Qt::ItemFlags SettingsItemModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    auto res = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    return (index.internalId() != 0 ? res | Qt::ItemNeverHasChildren : res);
+}
+
+bool SettingsItemModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid() || parent.internalId() != 0 || parent.row() >= static_cast<int>(m_visibleSections.size())) {
+        return false;
+    }
+    auto& section = m_sections[m_visibleSections[parent.row()]];
+    return (section.fetchedCount < static_cast<int>(section.visibleRows.size()));
+}
+
+void SettingsItemModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    auto& section = m_sections[m_visibleSections[parent.row()]];
+    auto fetchedCount = std::min(FETCH_CHUNK_SIZE, static_cast<int>(section.visibleRows.size()) - section.fetchedCount);
+    beginInsertRows(parent, section.fetchedCount, section.fetchedCount + fetchedCount - 1);
+    section.fetchedCount += fetchedCount;
+    endInsertRows();
+}
+
+void SettingsItemModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= ColumnsCount) {
+        return;
+    }
+    m_sortColumn = column;
+    m_sortOrder = order;
+    auto generation = ++m_sortGeneration;
+    auto structureVersion = m_structureVersion;
+    runJob([this, generation, structureVersion, snapshot = makeSnapshot(true), comparator = makeComparator()]() mutable {
+        for (std::size_t i = 0; i < snapshot.visibleRows.size(); ++i) {
+            std::stable_sort(snapshot.visibleRows[i].begin(), snapshot.visibleRows[i].end(), [&](uint32_t a, uint32_t b) {
+                return comparator(snapshot.getSortKey(i, a), snapshot.getSortKey(i, b));
+            });
+        }
+        return std::function<void()>([this, generation, structureVersion, visibleRows = std::move(snapshot.visibleRows)]() mutable {
+            applySort(generation, structureVersion, std::move(visibleRows));
+        });
+    });
+}
+
+void SettingsItemModel::setFilter(const QString &text)
+{
+    m_filter = text;
+    m_filterText.clear();
+    appendLower(m_filterText, text.toStdString());
+    startFilter();
+}
+
+QString SettingsItemModel::getFilter() const
+{
+    return m_filter;
+}
+
+bool SettingsItemModel::isBusy() const
+{
+    std::lock_guard lock(m_jobsMx);
+    return (m_pendingResultsCount != 0);
+}
+
+void SettingsItemModel::buildSections()
+{
+    std::vector<Rows_t> sectionsRows;
+    {
+        auto lock = m_settings.lockShared();
+        m_settings.forEachSetting([this, &sectionsRows](const std::string& section, const std::shared_ptr<AppSetting>& pSetting) {
+            auto [sectionIt, isAdded] = m_sectionIds.try_emplace(section, static_cast<uint32_t>(m_sections.size()));
+            if (isAdded) {
+                m_sections.push_back({section, nullptr, {}, 0});
+                sectionsRows.emplace_back();
+            }
+            // Settings of section come ordered by name, because full keys are ordered
+            sectionsRows[sectionIt->second].push_back(pSetting);
+        });
+    }
+
+    for (std::size_t i = 0; i < m_sections.size(); ++i) {
+        auto& section = m_sections[i];
+        section.visibleRows.resize(sectionsRows[i].size());
+        std::iota(section.visibleRows.begin(), section.visibleRows.end(), 0);
+        section.fetchedCount = std::min(FETCH_CHUNK_SIZE, static_cast<int>(section.visibleRows.size()));
+        section.pRows = std::make_shared<const Rows_t>(std::move(sectionsRows[i]));
+        m_visibleSections.push_back(static_cast<uint32_t>(i));
+    }
+    std::sort(m_visibleSections.begin(), m_visibleSections.end(), [this](uint32_t a, uint32_t b) {
+        return m_sections[a].name < m_sections[b].name;
+    });
+}
+
+SettingsItemModel::Snapshot SettingsItemModel::makeSnapshot(bool isWithVisibleRows) const
+{
+    Snapshot res;
+    res.sectionsRows.reserve(m_sections.size());
+    res.sectionNames.reserve(m_sections.size());
+    for (auto& section : m_sections) {
+        res.sectionsRows.push_back(section.pRows);
+        res.sectionNames.push_back(section.name);
+        if (isWithVisibleRows) {
+            res.visibleRows.push_back(section.visibleRows);
+        }
+        if (m_sortColumn == ValueColumn) {
+            auto& values = res.sectionsValues.emplace_back();
+            values.reserve(section.pRows->size());
+            for (auto& pSetting : *section.pRows) {
+                values.push_back(pSetting->getValueString());
+            }
+        }
+    }
+    return res;
+}
+
+SettingsItemModel::SortKey SettingsItemModel::Snapshot::getSortKey(std::size_t sectionIndex, uint32_t row) const
+{
+    return {(*sectionsRows[sectionIndex])[row]->getName(),
+            (sectionsValues.empty() ? std::string_view() : std::string_view(sectionsValues[sectionIndex][row]))};
+}
+
+std::function<bool (const SettingsItemModel::SortKey &, const SettingsItemModel::SortKey &)> SettingsItemModel::makeComparator() const
+{
+    auto isDescending = (m_sortOrder == Qt::DescendingOrder);
+    return [isDescending](const SortKey& a, const SortKey& b) {
+        auto& first = (isDescending ? b : a);
+        auto& second = (isDescending ? a : b);
+        if (first.value != second.value) {
+            return first.value < second.value;
+        }
+        return first.name < second.name;
+    };
+}
+
+void SettingsItemModel::runJob(std::function<std::function<void ()> ()> &&job)
+{
+    {
+        std::lock_guard lock(m_jobsMx);
+        ++m_runningJobsCount;
+        ++m_pendingResultsCount;
+    }
+    Executor::getInstance().post([this, job = std::move(job)]() {
+        std::function<void()> apply;
+        try {
+            apply = job();
+        } catch (const std::exception& ex) {
+            COMPLOG_ERROR("SettingsItemModel: background job failed:", ex.what());
+        }
+        QMetaObject::invokeMethod(this, [this, apply]() {
+            {
+                std::lock_guard lock(m_jobsMx);
+                --m_pendingResultsCount;
+            }
+            if (apply) {
+                apply();
+            }
+        }, Qt::QueuedConnection);
+
+        std::lock_guard lock(m_jobsMx);
+        --m_runningJobsCount;
+        m_jobsCv.notify_all();
+    });
+}
+
+void SettingsItemModel::startFilter()
+{
+    // Refined filter matches subset of rows, matching current one
+    auto isRefining = (m_filterText.find(m_appliedFilterText) != std::string::npos);
+    auto isSortedByName = (m_sortColumn != ValueColumn && m_sortOrder == Qt::AscendingOrder);
+    auto generation = ++m_filterGeneration;
+    auto structureVersion = m_structureVersion;
+    runJob([this, generation, structureVersion, isRefining, isSortedByName, filterText = m_filterText,
+            snapshot = makeSnapshot(isRefining), comparator = makeComparator()]() mutable {
+        std::vector<std::vector<uint32_t> > visibleRows(snapshot.sectionsRows.size());
+        std::string key;
+        for (std::size_t i = 0; i < snapshot.sectionsRows.size(); ++i) {
+            auto& rows = *snapshot.sectionsRows[i];
+            std::string sectionPrefix;
+            appendLower(sectionPrefix, snapshot.sectionNames[i]);
+            sectionPrefix += '.';
+
+            auto isMatching = [&](uint32_t row) {
+                key = sectionPrefix;
+                appendLower(key, rows[row]->getName());
+                return (key.find(filterText) != std::string::npos);
+            };
+            if (isRefining) {
+                std::copy_if(snapshot.visibleRows[i].begin(), snapshot.visibleRows[i].end(), std::back_inserter(visibleRows[i]), isMatching);
+                continue;
+            }
+            for (uint32_t row = 0; row < rows.size(); ++row) {
+                if (filterText.empty() || isMatching(row)) {
+                    visibleRows[i].push_back(row);
+                }
+            }
+            if (!isSortedByName) {
+                std::stable_sort(visibleRows[i].begin(), visibleRows[i].end(), [&](uint32_t a, uint32_t b) {
+                    return comparator(snapshot.getSortKey(i, a), snapshot.getSortKey(i, b));
+                });
+            }
+        }
+        return std::function<void()>([this, generation, structureVersion, filterText, visibleRows = std::move(visibleRows)]() mutable {
+            applyFilter(generation, structureVersion, filterText, std::move(visibleRows));
+        });
+    });
+}
+
+void SettingsItemModel::applyFilter(uint64_t generation, uint64_t structureVersion, const std::string &filterText,
+                                    std::vector<std::vector<uint32_t> > &&visibleRows)
+{
+    if (generation != m_filterGeneration) {
+        return; // Filter was changed again
+    }
+    if (structureVersion != m_structureVersion || visibleRows.size() != m_sections.size()) {
+        startFilter(); // Rows were changed meanwhile
+        return;
+    }
+
+    beginResetModel();
+    m_visibleSections.clear();
+    for (std::size_t i = 0; i < m_sections.size(); ++i) {
+        auto& section = m_sections[i];
+        section.visibleRows = std::move(visibleRows[i]);
+        section.fetchedCount = std::min(FETCH_CHUNK_SIZE, static_cast<int>(section.visibleRows.size()));
+        if (!section.visibleRows.empty()) {
+            m_visibleSections.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(m_visibleSections.begin(), m_visibleSections.end(), [this](uint32_t a, uint32_t b) {
+        return m_sections[a].name < m_sections[b].name;
+    });
+    m_appliedFilterText = filterText;
+    ++m_structureVersion;
+    endResetModel();
+}
+
+void SettingsItemModel::applySort(uint64_t generation, uint64_t structureVersion, std::vector<std::vector<uint32_t> > &&visibleRows)
+{
+    if (generation != m_sortGeneration) {
+        return;
+    }
+    if (structureVersion != m_structureVersion || visibleRows.size() != m_sections.size()) {
+        sort(m_sortColumn, m_sortOrder);
+        return;
+    }
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // Persistent indexes follow their settings to new positions
+    auto fromIndexes = persistentIndexList();
+    std::vector<std::pair<uint32_t, uint32_t> > persistentRows; // Section id, row in section rows
+    persistentRows.reserve(fromIndexes.size());
+    for (auto& fromIndex : fromIndexes) {
+        auto sectionId = static_cast<uint32_t>(fromIndex.internalId() - 1);
+        persistentRows.emplace_back(sectionId, (fromIndex.internalId() != 0 ? m_sections[sectionId].visibleRows[fromIndex.row()] : 0));
+    }
+
+    for (std::size_t i = 0; i < m_sections.size(); ++i) {
+        m_sections[i].visibleRows = std::move(visibleRows[i]);
+    }
+
+    std::unordered_map<uint32_t, std::vector<int> > newPositions; // Section id -> position of each row
+    QModelIndexList toIndexes;
+    toIndexes.reserve(fromIndexes.size());
+    for (int i = 0; i < fromIndexes.size(); ++i) {
+        auto& fromIndex = fromIndexes[i];
+        if (fromIndex.internalId() == 0) {
+            toIndexes.push_back(fromIndex);
+            continue;
+        }
+        auto [sectionId, row] = persistentRows[i];
+        auto& section = m_sections[sectionId];
+        auto& positions = newPositions[sectionId];
+        if (positions.empty()) {
+            positions.resize(section.pRows->size());
+            for (std::size_t position = 0; position < section.visibleRows.size(); ++position) {
+                positions[section.visibleRows[position]] = static_cast<int>(position);
+            }
+        }
+        auto position = positions[row];
+        toIndexes.push_back(position < section.fetchedCount ? createIndex(position, fromIndex.column(), fromIndex.internalId()) : QModelIndex());
+    }
+    changePersistentIndexList(fromIndexes, toIndexes);
+    ++m_structureVersion;
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void SettingsItemModel::applyChanges(const std::vector<SettingChange> &changes)
+{
+    for (auto& change : changes) {
+        auto pSetting = m_settings.getSetting(change.section, change.name);
+        auto sectionIt = m_sectionIds.find(change.section);
+        if (sectionIt == m_sectionIds.end() && !pSetting) {
+            continue;
+        }
+        auto sectionId = (sectionIt != m_sectionIds.end() ? sectionIt->second : findOrAddSection(change.section));
+        auto& section = m_sections[sectionId];
+        auto& rows = *section.pRows;
+        auto rowIt = std::lower_bound(rows.begin(), rows.end(), change.name, [](const std::shared_ptr<AppSetting>& pRow, const std::string& name) {
+            return pRow->getName() < name;
+        });
+        auto isFound = (rowIt != rows.end() && (*rowIt)->getName() == change.name);
+        auto row = static_cast<uint32_t>(rowIt - rows.begin());
+
+        if (!pSetting) {
+            if (isFound) {
+                removeSetting(sectionId, row);
+            }
+            continue;
+        }
+        if (!isFound) {
+            insertSetting(sectionId, pSetting);
+            continue;
+        }
+
+        if (*rowIt != pSetting) {
+            // Other layer provides setting now
+            auto pNewRows = std::make_shared<Rows_t>(rows);
+            (*pNewRows)[row] = pSetting;
+            section.pRows = std::move(pNewRows);
+        }
+        auto fetchedEnd = section.visibleRows.begin() + section.fetchedCount;
+        auto visibleIt = std::find(section.visibleRows.begin(), fetchedEnd, row);
+        if (visibleIt != fetchedEnd) {
+            auto position = static_cast<int>(visibleIt - section.visibleRows.begin());
+            emit dataChanged(createIndex(position, ValueColumn, quintptr(sectionId + 1)),
+                             createIndex(position, SourceColumn, quintptr(sectionId + 1)),
+                             {Qt::DisplayRole, Qt::ToolTipRole});
+        }
+    }
+}
+
+void SettingsItemModel::insertSetting(uint32_t sectionId, const std::shared_ptr<AppSetting> &pSetting)
+{
+    auto& section = m_sections[sectionId];
+    auto pNewRows = std::make_shared<Rows_t>(*section.pRows);
+    auto rowIt = std::lower_bound(pNewRows->begin(), pNewRows->end(), pSetting->getName(), [](const std::shared_ptr<AppSetting>& pRow, std::string_view name) {
+        return pRow->getName() < name;
+    });
+    auto row = static_cast<uint32_t>(rowIt - pNewRows->begin());
+    pNewRows->insert(rowIt, pSetting);
+    section.pRows = std::move(pNewRows);
+    for (auto& visibleRow : section.visibleRows) {
+        visibleRow += (visibleRow >= row ? 1 : 0);
+    }
+    ++m_structureVersion;
+
+    if (!isMatchingFilter(section.name, pSetting->getName())) {
+        return;
+    }
+    auto& rows = *section.pRows;
+    auto comparator = makeComparator();
+    auto isByValue = (m_sortColumn == ValueColumn);
+    std::string firstValue;
+    std::string secondValue;
+    auto getSortKey = [&](uint32_t rowIndex, std::string& value) {
+        if (isByValue) {
+            value = rows[rowIndex]->getValueString();
+        }
+        return SortKey {rows[rowIndex]->getName(), value};
+    };
+    auto visibleIt = std::lower_bound(section.visibleRows.begin(), section.visibleRows.end(), row, [&](uint32_t a, uint32_t b) {
+        return comparator(getSortKey(a, firstValue), getSortKey(b, secondValue));
+    });
+    auto position = static_cast<int>(visibleIt - section.visibleRows.begin());
+
+    if (section.visibleRows.empty()) {
+        // Section appears
+        auto sectionIt = std::lower_bound(m_visibleSections.begin(), m_visibleSections.end(), sectionId, [this](uint32_t a, uint32_t b) {
+            return m_sections[a].name < m_sections[b].name;
+        });
+        auto sectionRow = static_cast<int>(sectionIt - m_visibleSections.begin());
+        beginInsertRows({}, sectionRow, sectionRow);
+        section.visibleRows.push_back(row);
+        section.fetchedCount = 1;
+        m_visibleSections.insert(sectionIt, sectionId);
+        endInsertRows();
+    } else if (position <= section.fetchedCount) {
+        beginInsertRows(createIndex(findVisibleSectionRow(sectionId), 0, quintptr(0)), position, position);
+        section.visibleRows.insert(visibleIt, row);
+        ++section.fetchedCount;
+        endInsertRows();
+    } else {
+        section.visibleRows.insert(visibleIt, row); // Not fetched by view yet
+    }
+}
+
+void SettingsItemModel::removeSetting(uint32_t sectionId, uint32_t rowIndex)
+{
+    auto& section = m_sections[sectionId];
+    auto removeRow = [&section, rowIndex](std::vector<uint32_t>::iterator visibleIt) {
+        auto pNewRows = std::make_shared<Rows_t>(*section.pRows);
+        pNewRows->erase(pNewRows->begin() + rowIndex);
+        section.pRows = std::move(pNewRows);
+        if (visibleIt != section.visibleRows.end()) {
+            section.visibleRows.erase(visibleIt);
+        }
+        for (auto& visibleRow : section.visibleRows) {
+            visibleRow -= (visibleRow > rowIndex ? 1 : 0);
+        }
+    };
+    ++m_structureVersion;
+
+    auto visibleIt = std::find(section.visibleRows.begin(), section.visibleRows.end(), rowIndex);
+    auto position = static_cast<int>(visibleIt - section.visibleRows.begin());
+    if (visibleIt == section.visibleRows.end() || position >= section.fetchedCount) {
+        removeRow(visibleIt);
+        return;
+    }
+
+    auto sectionRow = findVisibleSectionRow(sectionId);
+    if (section.visibleRows.size() == 1) {
+        // Section disappears
+        beginRemoveRows({}, sectionRow, sectionRow);
+        removeRow(visibleIt);
+        section.fetchedCount = 0;
+        m_visibleSections.erase(m_visibleSections.begin() + sectionRow);
+        endRemoveRows();
+        return;
+    }
+    beginRemoveRows(createIndex(sectionRow, 0, quintptr(0)), position, position);
+    removeRow(visibleIt);
+    --section.fetchedCount;
+    endRemoveRows();
+}
+
+uint32_t SettingsItemModel::findOrAddSection(const std::string &sectionName)
+{
+    auto [sectionIt, isAdded] = m_sectionIds.try_emplace(sectionName, static_cast<uint32_t>(m_sections.size()));
+    if (isAdded) {
+        m_sections.push_back({sectionName, std::make_shared<const Rows_t>(), {}, 0});
+    }
+    return sectionIt->second;
+}
+
+int SettingsItemModel::findVisibleSectionRow(uint32_t sectionId) const
+{
+    auto& sectionName = m_sections[sectionId].name;
+    auto sectionIt = std::lower_bound(m_visibleSections.begin(), m_visibleSections.end(), sectionName, [this](uint32_t id, const std::string& name) {
+        return m_sections[id].name < name;
+    });
+    if (sectionIt == m_visibleSections.end() || *sectionIt != sectionId) {
+        return -1;
+    }
+    return static_cast<int>(sectionIt - m_visibleSections.begin());
+}
+
+bool SettingsItemModel::isMatchingFilter(const std::string &sectionName, std::string_view settingName) const
+{
+    if (m_appliedFilterText.empty()) {
+        return true;
+    }
+    std::string key;
+    appendLower(key, sectionName);
+    key += '.';
+    appendLower(key, settingName);
+    return (key.find(m_appliedFilterText) != std::string::npos);
+}
+
+const AppSetting *SettingsItemModel::getSetting(const QModelIndex &index) const
+{
+    if (index.internalId() == 0 || index.internalId() > m_sections.size()) {
+        return nullptr;
+    }
+    auto& section = m_sections[index.internalId() - 1];
+    if (index.row() >= section.fetchedCount) {
+        return nullptr;
+    }
+    return (*section.pRows)[section.visibleRows[index.row()]].get();
+}
+
+} // namespace Common
+
+#endif // COMPONENTS_IS_ENABLED_QT
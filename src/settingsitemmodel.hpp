@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+
+#include "applicationsettings.hpp"
+
+#include <QAbstractItemModel>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The SettingsItemModel class Two-level model (sections, then settings) over effective ApplicationSettings
+ * @note Values are not copied: model keeps only pointers to settings, text is taken from setting cache when
+ *       view asks for visible rows. Settings of section are exposed by chunks through fetchMore().
+ *       Filtering and sorting run in @ref Executor and are applied in thread of model.
+ *       Value changes are reported by dataChanged(), added and removed settings by row insertion and removal.
+ *       Sections are always ordered by name, sorting is applied to settings inside section
+ */
+class SettingsItemModel : public QAbstractItemModel
+{
+public:
+    enum Column
+    {
+        NameColumn,
+        ValueColumn,
+        SourceColumn,   // Layer, which provides value
+        ColumnsCount
+    };
+
+    explicit SettingsItemModel(ApplicationSettings& settings = ApplicationSettings::getInstance(), QObject* pParent = nullptr);
+    ~SettingsItemModel() override;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = {}) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = {}) const override;
+    int columnCount(const QModelIndex& parent = {}) const override;
+    bool hasChildren(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief sort  Sort settings of every section in background. Model emits layoutChanged() when done
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /**
+     * @brief setFilter Show settings, which full key "<section>.<name>" contains text (case insensitive).
+     *                  Filtered in background, model is reset when done. Refined filter checks only visible rows
+     */
+    void setFilter(const QString& text);
+    QString getFilter() const;
+
+    /**
+     * @brief isBusy    Check if filtering or sorting is not applied yet
+     */
+    bool isBusy() const;
+
+private:
+    using Rows_t = std::vector<std::shared_ptr<AppSetting> >;   // Ordered by name
+
+    struct Section
+    {
+        std::string                     name;
+        std::shared_ptr<const Rows_t>   pRows;          // Replaced on change, so background jobs read own snapshot
+        std::vector<uint32_t>           visibleRows;    // Indexes in rows, filtered and sorted
+        int                             fetchedCount {0};
+    };
+
+    struct SortKey
+    {
+        std::string_view    name;
+        std::string_view    value;  // Empty if not sorted by value
+    };
+
+    struct Snapshot
+    {
+        std::vector<std::shared_ptr<const Rows_t> > sectionsRows;
+        std::vector<std::string>                    sectionNames;
+        std::vector<std::vector<uint32_t> >         visibleRows;    // Candidates for refined filter
+        std::vector<std::vector<std::string> >      sectionsValues; // Read in thread of model, background jobs don't touch values
+
+        SortKey getSortKey(std::size_t sectionIndex, uint32_t row) const;
+    };
+    struct NotifierGuard;
+
+    ApplicationSettings&            m_settings;
+    std::vector<Section>            m_sections;         // Never reordered, index is id of section
+    std::unordered_map<std::string, uint32_t> m_sectionIds;
+    std::vector<uint32_t>           m_visibleSections;  // Ids of sections with visible settings, ordered by name
+
+    QString                         m_filter;
+    std::string                     m_filterText;       // Lower case
+    std::string                     m_appliedFilterText;
+    int                             m_sortColumn {NameColumn};
+    Qt::SortOrder                   m_sortOrder {Qt::AscendingOrder};
+    uint64_t                        m_structureVersion {0};
+    uint64_t                        m_filterGeneration {0};
+    uint64_t                        m_sortGeneration {0};
+
+    std::shared_ptr<NotifierGuard>  m_pNotifierGuard;
+    SettingsNotifier::SubscriptionId_t m_subscriptionId {0};
+
+    mutable std::mutex              m_jobsMx;
+    std::condition_variable         m_jobsCv;
+    int                             m_runningJobsCount {0};
+    int                             m_pendingResultsCount {0};
+
+    void buildSections();
+    Snapshot makeSnapshot(bool isWithVisibleRows) const;
+    std::function<bool(const SortKey&, const SortKey&)> makeComparator() const;
+    void runJob(std::function<std::function<void()>()>&& job);
+
+    void startFilter();
+    void applyFilter(uint64_t generation, uint64_t structureVersion, const std::string& filterText,
+                     std::vector<std::vector<uint32_t> >&& visibleRows);
+    void applySort(uint64_t generation, uint64_t structureVersion, std::vector<std::vector<uint32_t> >&& visibleRows);
+
+    void applyChanges(const std::vector<SettingChange>& changes);
+    void insertSetting(uint32_t sectionId, const std::shared_ptr<AppSetting>& pSetting);
+    void removeSetting(uint32_t sectionId, uint32_t rowIndex);
+    uint32_t findOrAddSection(const std::string& sectionName);
+    int findVisibleSectionRow(uint32_t sectionId) const;
+    bool isMatchingFilter(const std::string& sectionName, std::string_view settingName) const;
+
+    const AppSetting* getSetting(const QModelIndex& index) const;
+};
+
+} // namespace Common
+
+#endif // COMPONENTS_IS_ENABLED_QT
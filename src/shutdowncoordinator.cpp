@@ -0,0 +1,275 @@
+#include "shutdowncoordinator.hpp"
+
+#include "utility.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+// Write end of pipe of coordinator, which handles signals. Only async-signal-safe write() is used in handler
+std::atomic<int> signalWriteFd {-1};
+
+std::chrono::microseconds getElapsed(std::chrono::steady_clock::time_point startTime) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+}
+
+} // namespace
+
+
+struct ShutdownCoordinator::RunState
+{
+    std::mutex                                          mx;
+    std::condition_variable                             cv;
+    std::vector<HookEntry>                              hooks;
+    std::vector<std::vector<std::size_t> >              dependents;
+    std::vector<std::size_t>                            remainingCounts;
+    std::vector<ShutdownHookReport>                     reports;
+    std::vector<std::chrono::steady_clock::time_point>  startTimes;
+    std::size_t                                         finishedCount {0};
+};
+
+
+ShutdownCoordinator::~ShutdownCoordinator()
+{
+    if (m_signalThread.joinable()) {
+        int expectedFd = m_signalPipe[1];
+        signalWriteFd.compare_exchange_strong(expectedFd, -1);
+        ::close(m_signalPipe[1]); // Wakes signal thread
+        m_signalThread.join();
+        ::close(m_signalPipe[0]);
+    }
+}
+
+ShutdownCoordinator &ShutdownCoordinator::getInstance()
+{
+    static ShutdownCoordinator inst;
+    return inst;
+}
+
+bool ShutdownCoordinator::addHook(const std::string &name, Hook_t &&hook, const std::vector<std::string> &afterHooks)
+{
+    std::lock_guard lock(m_mx);
+    if (m_isStarted) {
+        COMPLOG_ERROR("ShutdownCoordinator: hook is added after shutdown start:", name);
+        return false;
+    }
+
+    auto findIndex = [this](const std::string& hookName) {
+        for (std::size_t i = 0; i < m_hooks.size(); ++i) {
+            if (m_hooks[i].name == hookName) {
+                return i;
+            }
+        }
+        return m_hooks.size();
+    };
+    if (findIndex(name) != m_hooks.size()) {
+        COMPLOG_ERROR("ShutdownCoordinator: hook already exists:", name);
+        return false;
+    }
+
+    // Dependencies must exist already, so cycles are impossible
+    HookEntry entry {name, std::move(hook), {}};
+    for (auto& afterHook : afterHooks) {
+        auto afterIndex = findIndex(afterHook);
+        if (afterIndex == m_hooks.size()) {
+            COMPLOG_ERROR("ShutdownCoordinator: unknown dependency of hook:", name, afterHook);
+            return false;
+        }
+        entry.afterIndexes.push_back(afterIndex);
+    }
+    m_hooks.push_back(std::move(entry));
+    return true;
+}
+
+bool ShutdownCoordinator::shutdown(const ShutdownOptions &options)
+{
+    auto deadlineTime = std::chrono::steady_clock::now() + options.deadline;
+    auto pRunState = std::make_shared<RunState>();
+    {
+        std::unique_lock lock(m_mx);
+        if (m_isStarted) {
+            m_cv.wait(lock, [this]() { return m_isFinished; });
+            return m_result;
+        }
+        m_isStarted = true;
+        m_pRunState = pRunState;
+
+        auto hooksCount = m_hooks.size();
+        pRunState->dependents.resize(hooksCount);
+        pRunState->remainingCounts.resize(hooksCount);
+        pRunState->reports.resize(hooksCount);
+        pRunState->startTimes.resize(hooksCount);
+        for (std::size_t i = 0; i < hooksCount; ++i) {
+            for (auto afterIndex : m_hooks[i].afterIndexes) {
+                pRunState->dependents[afterIndex].push_back(i);
+            }
+            pRunState->remainingCounts[i] = m_hooks[i].afterIndexes.size();
+            pRunState->reports[i].name = m_hooks[i].name;
+        }
+        pRunState->hooks = std::move(m_hooks);
+        m_hooks.clear();
+    }
+    COMPLOG_INFO("ShutdownCoordinator: stopping, hooks:", pRunState->hooks.size());
+
+    std::vector<ShutdownHookReport> reports;
+    bool isCompleted;
+    {
+        std::unique_lock lock(pRunState->mx);
+        for (std::size_t i = 0; i < pRunState->hooks.size(); ++i) {
+            if (pRunState->remainingCounts[i] == 0) {
+                startHook(pRunState, i);
+            }
+        }
+        isCompleted = pRunState->cv.wait_until(lock, deadlineTime, [&pRunState]() {
+            return (pRunState->finishedCount == pRunState->hooks.size());
+        });
+    }
+    reports = getReports();
+    logReports(reports);
+
+    if (!isCompleted) {
+        std::string pendingNames;
+        for (auto& report : reports) {
+            if (!report.isCompleted) {
+                pendingNames += (pendingNames.empty() ? "" : ", ") + report.name;
+            }
+        }
+        COMPLOG_ERROR_SYNC("ShutdownCoordinator: deadline exceeded, not finished:", pendingNames);
+        if (options.isForcingExit) {
+            std::_Exit(options.timeoutExitCode);
+        }
+    } else {
+        COMPLOG_INFO_SYNC("ShutdownCoordinator: stopped");
+    }
+
+    {
+        std::lock_guard lock(m_mx);
+        m_isFinished = true;
+        m_result = isCompleted;
+    }
+    m_cv.notify_all();
+    return isCompleted;
+}
+
+void ShutdownCoordinator::setupSignalHandling(const ShutdownOptions &options)
+{
+    {
+        std::lock_guard lock(m_mx);
+        if (m_signalThread.joinable()) {
+            return;
+        }
+        if (::pipe2(m_signalPipe, O_CLOEXEC) != 0) {
+            COMPLOG_ERROR("ShutdownCoordinator: failed to create signal pipe");
+            return;
+        }
+        m_signalThread = std::thread([this, options]() {
+            char signalByte;
+            while (::read(m_signalPipe[0], &signalByte, 1) < 0 && errno == EINTR) {
+
+            }
+            if (!isShutdownStarted() && signalWriteFd.load() != -1) {
+                shutdown(options);
+            }
+        });
+        signalWriteFd.store(m_signalPipe[1]);
+    }
+
+    setupBacktrace([](int signo) {
+        if (signo != SIGTERM) {
+            return false;
+        }
+        auto writeFd = signalWriteFd.load();
+        if (writeFd < 0) {
+            return false; // Coordinator is destroyed
+        }
+        char signalByte = static_cast<char>(signo);
+        [[maybe_unused]] auto res = ::write(writeFd, &signalByte, 1);
+        return true;
+    });
+}
+
+bool ShutdownCoordinator::isShutdownStarted() const
+{
+    std::lock_guard lock(m_mx);
+    return m_isStarted;
+}
+
+bool ShutdownCoordinator::waitShutdown()
+{
+    std::unique_lock lock(m_mx);
+    m_cv.wait(lock, [this]() { return m_isFinished; });
+    return m_result;
+}
+
+std::vector<ShutdownHookReport> ShutdownCoordinator::getReports() const
+{
+    std::shared_ptr<RunState> pRunState;
+    {
+        std::lock_guard lock(m_mx);
+        pRunState = m_pRunState;
+    }
+    if (!pRunState) {
+        return {};
+    }
+
+    std::lock_guard lock(pRunState->mx);
+    auto reports = pRunState->reports;
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        if (reports[i].isStarted && !reports[i].isCompleted) {
+            reports[i].duration = getElapsed(pRunState->startTimes[i]);
+        }
+    }
+    return reports;
+}
+
+void ShutdownCoordinator::startHook(const std::shared_ptr<RunState> &pRunState, std::size_t hookIndex)
+{
+    // Called under pRunState->mx
+    pRunState->reports[hookIndex].isStarted = true;
+    pRunState->startTimes[hookIndex] = std::chrono::steady_clock::now();
+    std::thread([pRunState, hookIndex]() {
+        bool isFailed {false};
+        try {
+            pRunState->hooks[hookIndex].hook();
+        } catch (const std::exception& ex) {
+            COMPLOG_ERROR("ShutdownCoordinator: hook failed:", pRunState->hooks[hookIndex].name, ex.what());
+            isFailed = true;
+        } catch (...) {
+            COMPLOG_ERROR("ShutdownCoordinator: hook failed:", pRunState->hooks[hookIndex].name);
+            isFailed = true;
+        }
+
+        std::lock_guard lock(pRunState->mx);
+        auto& report = pRunState->reports[hookIndex];
+        report.duration = getElapsed(pRunState->startTimes[hookIndex]);
+        report.isCompleted = true;
+        report.isFailed = isFailed;
+        for (auto dependentIndex : pRunState->dependents[hookIndex]) {
+            if (--pRunState->remainingCounts[dependentIndex] == 0) {
+                startHook(pRunState, dependentIndex);
+            }
+        }
+        ++pRunState->finishedCount;
+        pRunState->cv.notify_all();
+    }).detach();
+}
+
+void ShutdownCoordinator::logReports(const std::vector<ShutdownHookReport> &reports)
+{
+    for (auto& report : reports) {
+        auto status = (!report.isStarted ? "not started" : (!report.isCompleted ? "running" : (report.isFailed ? "failed" : "done")));
+        COMPLOG_INFO_SYNC("ShutdownCoordinator: hook", report.name, status, "in", report.duration.count() / 1000.0, "ms");
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "commonapplicationconstants.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The ShutdownOptions struct Parameters of @ref ShutdownCoordinator run
+ */
+struct ShutdownOptions
+{
+    std::chrono::milliseconds   deadline {10000};                           // For all hooks together
+    bool                        isForcingExit {true};                       // Exit process when deadline passes
+    int                         timeoutExitCode {APP_EXITCODE_SHUTDOWN_TIMEOUT};
+};
+
+/**
+ * @brief The ShutdownHookReport struct Result of one stop hook
+ */
+struct ShutdownHookReport
+{
+    std::string                 name;
+    bool                        isStarted {false};
+    bool                        isCompleted {false};
+    bool                        isFailed {false};   // Hook has thrown
+    std::chrono::microseconds   duration {0};       // Until now, if not completed
+};
+
+/**
+ * @brief The ShutdownCoordinator class Runs stop hooks of components in parallel, respecting dependencies
+ * @note Each hook runs in own detached thread, so hung hook can't delay exit beyond deadline.
+ *       Hook starts when all hooks it waits for are finished (completed or failed)
+ */
+class ShutdownCoordinator : public boost::noncopyable
+{
+public:
+    using Hook_t = std::function<void()>;
+
+    ShutdownCoordinator() = default;
+    ~ShutdownCoordinator();
+
+    static ShutdownCoordinator& getInstance();
+
+    /**
+     * @brief addHook       Register stop hook
+     * @param name          Unique name
+     * @param hook          Stop function
+     * @param afterHooks    Names of hooks, which must finish before this one starts. Must be added earlier
+     * @return              false if name is taken, dependency is unknown or shutdown is started
+     */
+    bool addHook(const std::string& name, Hook_t&& hook, const std::vector<std::string>& afterHooks = {});
+
+    /**
+     * @brief shutdown  Run all hooks and wait for them until deadline. Repeated call waits for the first one
+     * @return          true if all hooks finished in time. Process is terminated instead of returning false,
+     *                  if options.isForcingExit
+     */
+    bool shutdown(const ShutdownOptions& options = {});
+
+    /**
+     * @brief setupSignalHandling   Run shutdown in background thread on SIGTERM
+     * @note Replaces signal processor, passed to @ref setupBacktrace. Other signals are handled as before
+     */
+    void setupSignalHandling(const ShutdownOptions& options = {});
+
+    bool isShutdownStarted() const;
+
+    /**
+     * @brief waitShutdown  Wait until shutdown is finished, e.g. in main() after signal handling is set up
+     * @return              Result of @ref shutdown
+     */
+    bool waitShutdown();
+
+    /**
+     * @brief getReports    Per-hook timings of current or finished shutdown
+     */
+    std::vector<ShutdownHookReport> getReports() const;
+
+private:
+    struct HookEntry
+    {
+        std::string             name;
+        Hook_t                  hook;
+        std::vector<std::size_t> afterIndexes;
+    };
+    struct RunState;
+
+    mutable std::mutex                  m_mx;
+    std::condition_variable             m_cv;
+    std::vector<HookEntry>              m_hooks;
+    std::shared_ptr<RunState>           m_pRunState;
+    bool                                m_isStarted {false};
+    bool                                m_isFinished {false};
+    bool                                m_result {false};
+
+    int                                 m_signalPipe[2] {-1, -1};
+    std::thread                         m_signalThread;
+
+    static void startHook(const std::shared_ptr<RunState>& pRunState, std::size_t hookIndex);
+    static void logReports(const std::vector<ShutdownHookReport>& reports);
+};
+
+} // namespace Common
@@ -0,0 +1,217 @@
+#include "symbolizer.hpp"
+
+#include <boost/core/demangle.hpp>
+#include <boost/stacktrace/stacktrace.hpp>
+
+#include <cstdio>
+
+#include <dlfcn.h>
+
+#ifdef COMMON_IS_ENABLED_LIBBACKTRACE
+#include <backtrace.h>
+#endif // COMMON_IS_ENABLED_LIBBACKTRACE
+
+namespace Common {
+
+namespace {
+
+#ifdef COMMON_IS_ENABLED_LIBBACKTRACE
+struct ResolvedLocation
+{
+    std::string function;
+    std::string file;
+    int         line {0};
+};
+
+void ignoreError(void*, const char*, int) {
+
+}
+#endif // COMMON_IS_ENABLED_LIBBACKTRACE
+
+std::string formatAddress(const void* pAddress) {
+    char buffer[2 + 2 * sizeof(void*) + 1];
+    std::snprintf(buffer, sizeof(buffer), "%p", pAddress);
+    return buffer;
+}
+
+} // namespace
+
+
+CapturedStacktrace CapturedStacktrace::capture(std::size_t skip, std::size_t maxDepth)
+{
+    CapturedStacktrace res;
+    boost::stacktrace::stacktrace stacktrace(skip + 1, maxDepth);
+    res.frames.reserve(stacktrace.size());
+    for (auto& frame : stacktrace) {
+        res.frames.push_back(frame.address());
+    }
+    return res;
+}
+
+
+Symbolizer::Symbolizer()
+{
+#ifdef COMMON_IS_ENABLED_LIBBACKTRACE
+    // State keeps parsed DWARF for the process lifetime, libbacktrace has no way to free it
+    m_pState = ::backtrace_create_state(nullptr, 1, &ignoreError, nullptr);
+#endif // COMMON_IS_ENABLED_LIBBACKTRACE
+}
+
+Symbolizer::~Symbolizer()
+{
+    {
+        std::lock_guard lock(m_requestsMx);
+        m_isStopping = true;
+    }
+    m_requestsCv.notify_all();
+    if (m_workerThread.joinable()) {
+        m_workerThread.join();
+    }
+}
+
+Symbolizer &Symbolizer::getInstance()
+{
+    static Symbolizer inst;
+    return inst;
+}
+
+const std::string &Symbolizer::symbolize(const void *pAddress)
+{
+    {
+        std::shared_lock lock(m_cacheMx);
+        if (auto cacheIt = m_cache.find(pAddress); cacheIt != m_cache.end()) {
+            return cacheIt->second;
+        }
+    }
+
+    // Resolved without lock, concurrent resolving of the same address is harmless
+    auto location = resolve(pAddress);
+    std::unique_lock lock(m_cacheMx);
+    return m_cache.try_emplace(pAddress, std::move(location)).first->second;
+}
+
+std::vector<std::string> Symbolizer::symbolize(const CapturedStacktrace &stacktrace)
+{
+    std::vector<std::string> res;
+    res.reserve(stacktrace.frames.size());
+    for (auto pAddress : stacktrace.frames) {
+        res.push_back(symbolize(pAddress));
+    }
+    return res;
+}
+
+std::vector<std::string> Symbolizer::symbolizeNoWait(const CapturedStacktrace &stacktrace) const
+{
+    std::vector<std::string> res;
+    res.reserve(stacktrace.frames.size());
+    std::shared_lock lock(m_cacheMx, std::try_to_lock);
+    for (auto pAddress : stacktrace.frames) {
+        auto cacheIt = (lock.owns_lock() ? m_cache.find(pAddress) : m_cache.end());
+        res.push_back(lock.owns_lock() && cacheIt != m_cache.end() ? cacheIt->second : resolve(pAddress));
+    }
+    return res;
+}
+
+void Symbolizer::symbolizeAsync(CapturedStacktrace &&stacktrace, Handler_t &&handler)
+{
+    {
+        std::lock_guard lock(m_requestsMx);
+        m_requests.push_back({std::move(stacktrace), std::move(handler)});
+        if (!m_workerThread.joinable()) {
+            m_workerThread = std::thread(&Symbolizer::workerLoop, this);
+        }
+    }
+    m_requestsCv.notify_all();
+}
+
+void Symbolizer::waitIdle()
+{
+    std::unique_lock lock(m_requestsMx);
+    m_requestsCv.wait(lock, [this]() {
+        return (m_requests.empty() && !m_isProcessing);
+    });
+}
+
+std::size_t Symbolizer::getCacheSize() const
+{
+    std::shared_lock lock(m_cacheMx);
+    return m_cache.size();
+}
+
+std::string Symbolizer::resolve(const void *pAddress) const
+{
+    // Frames hold return addresses, which may belong to the next line or even next function
+    auto pc = reinterpret_cast<uintptr_t>(pAddress);
+    auto lookupPc = (pc != 0 ? pc - 1 : pc);
+
+#ifdef COMMON_IS_ENABLED_LIBBACKTRACE
+    if (m_pState) {
+        auto pState = static_cast<backtrace_state*>(m_pState);
+        ResolvedLocation location;
+        ::backtrace_pcinfo(pState, lookupPc,
+            [](void* pData, uintptr_t, const char* pFile, int line, const char* pFunction) {
+                auto& location = *static_cast<ResolvedLocation*>(pData);
+                if (pFunction) {
+                    location.function = pFunction;
+                }
+                if (pFile) {
+                    location.file = pFile;
+                    location.line = line;
+                }
+                return 1; // Innermost inlined function is enough
+            }, &ignoreError, &location);
+        if (location.function.empty()) {
+            ::backtrace_syminfo(pState, lookupPc,
+                [](void* pData, uintptr_t, const char* pSymbol, uintptr_t, uintptr_t) {
+                    if (pSymbol) {
+                        static_cast<ResolvedLocation*>(pData)->function = pSymbol;
+                    }
+                }, &ignoreError, &location);
+        }
+
+        if (!location.function.empty()) {
+            auto res = boost::core::demangle(location.function.c_str());
+            if (!location.file.empty()) {
+                res += " at " + location.file + ":" + std::to_string(location.line);
+            }
+            return res;
+        }
+    }
+#endif // COMMON_IS_ENABLED_LIBBACKTRACE
+
+    Dl_info info {};
+    if (::dladdr(reinterpret_cast<const void*>(lookupPc), &info) != 0) {
+        std::string res = (info.dli_sname ? boost::core::demangle(info.dli_sname) : formatAddress(pAddress));
+        if (info.dli_fname) {
+            res += " in ";
+            res += info.dli_fname;
+            res += " [" + formatAddress(reinterpret_cast<const void*>(pc - reinterpret_cast<uintptr_t>(info.dli_fbase))) + "]";
+        }
+        return res;
+    }
+    return formatAddress(pAddress);
+}
+
+void Symbolizer::workerLoop()
+{
+    std::unique_lock lock(m_requestsMx);
+    while (true) {
+        m_requestsCv.wait(lock, [this]() {
+            return (!m_requests.empty() || m_isStopping);
+        });
+        if (m_requests.empty()) {
+            break; // Stopping
+        }
+
+        auto request = std::move(m_requests.front());
+        m_requests.pop_front();
+        m_isProcessing = true;
+        lock.unlock();
+        request.handler(symbolize(request.stacktrace));
+        lock.lock();
+        m_isProcessing = false;
+        m_requestsCv.notify_all();
+    }
+}
+
+} // namespace Common
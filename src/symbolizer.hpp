@@ -0,0 +1,96 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Common {
+
+/**
+ * @brief The CapturedStacktrace struct Raw return addresses of stack, cheap to capture and copy
+ */
+struct CapturedStacktrace
+{
+    std::vector<const void*> frames;
+
+    /**
+     * @brief capture   Capture stack of current thread
+     * @param skip      Count of innermost frames to skip, not including capture() itself
+     * @param maxDepth  Max count of frames
+     */
+    static CapturedStacktrace capture(std::size_t skip = 0, std::size_t maxDepth = 64);
+};
+
+/**
+ * @brief The Symbolizer class In-process address to "function at file:line" resolver with persistent cache
+ * @note Uses libbacktrace (DWARF) if available, otherwise dladdr symbols of dynamic symbol table.
+ *       Without libbacktrace file:line is not known, module and offset in it are given for offline addr2line.
+ *       Each address is resolved once per process, repeated traces are formatted from cache
+ */
+class Symbolizer : public boost::noncopyable
+{
+public:
+    using Handler_t = std::function<void(const std::vector<std::string>&)>;
+
+    Symbolizer();
+    ~Symbolizer();
+
+    static Symbolizer& getInstance();
+
+    /**
+     * @brief symbolize Resolve address
+     * @return          Reference is valid until symbolizer is destroyed
+     */
+    const std::string& symbolize(const void* pAddress);
+    std::vector<std::string> symbolize(const CapturedStacktrace& stacktrace);
+
+    /**
+     * @brief symbolizeNoWait   Resolve stack without waiting for locks of symbolizer. Cache is used only if it is
+     *                          not locked, and is not updated
+     * @note For signal handlers: interrupted thread may hold the lock
+     */
+    std::vector<std::string> symbolizeNoWait(const CapturedStacktrace& stacktrace) const;
+
+    /**
+     * @brief symbolizeAsync    Resolve stack in background thread and pass result to handler there
+     */
+    void symbolizeAsync(CapturedStacktrace&& stacktrace, Handler_t&& handler);
+
+    /**
+     * @brief waitIdle  Wait until all background requests are processed
+     */
+    void waitIdle();
+
+    std::size_t getCacheSize() const;
+
+private:
+    struct Request
+    {
+        CapturedStacktrace  stacktrace;
+        Handler_t           handler;
+    };
+
+    void*                                           m_pState {nullptr};    // backtrace_state
+    mutable std::shared_mutex                       m_cacheMx;
+    std::unordered_map<const void*, std::string>    m_cache;
+
+    std::mutex                                      m_requestsMx;
+    std::condition_variable                         m_requestsCv;
+    std::deque<Request>                             m_requests;
+    bool                                            m_isProcessing {false};
+    bool                                            m_isStopping {false};
+    std::thread                                     m_workerThread;
+
+    std::string resolve(const void* pAddress) const;
+    void workerLoop();
+};
+
+} // namespace Common
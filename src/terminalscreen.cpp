@@ -0,0 +1,275 @@
+#include "terminalscreen.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <sys/ioctl.h>
+
+namespace Common {
+
+namespace {
+
+// Unchanged cells between changed ones are rewritten, if it is shorter than cursor move
+constexpr unsigned MAX_REWRITTEN_GAP {4};
+
+/**
+ * @brief decodeUtf8    Decode one code point and advance position. Invalid byte is decoded as U+FFFD
+ */
+char32_t decodeUtf8(std::string_view text, std::size_t& pos) {
+    auto leadByte = static_cast<uint8_t>(text[pos++]);
+    if (leadByte < 0x80) {
+        return leadByte;
+    }
+
+    int continuationCount = (leadByte >= 0xF0 ? 3 : (leadByte >= 0xE0 ? 2 : (leadByte >= 0xC0 ? 1 : -1)));
+    if (continuationCount < 0 || pos + continuationCount > text.size()) {
+        return U'\uFFFD';
+    }
+    char32_t res = leadByte & (0x3F >> continuationCount);
+    for (int i = 0; i < continuationCount; ++i) {
+        auto byte = static_cast<uint8_t>(text[pos]);
+        if ((byte & 0xC0) != 0x80) {
+            return U'\uFFFD';
+        }
+        res = (res << 6) | (byte & 0x3F);
+        ++pos;
+    }
+    return res;
+}
+
+/**
+ * @brief toPrintable   Replace control character with U+FFFD, terminal would execute it instead of showing it in cell
+ */
+char32_t toPrintable(char32_t ch) {
+    return ((ch < 0x20 || (ch >= 0x7F && ch < 0xA0)) ? U'\uFFFD' : ch);
+}
+
+void appendUtf8(std::string& output, char32_t ch) {
+    if (ch < 0x80) {
+        output += static_cast<char>(ch);
+    } else if (ch < 0x800) {
+        output += static_cast<char>(0xC0 | (ch >> 6));
+        output += static_cast<char>(0x80 | (ch & 0x3F));
+    } else if (ch < 0x10000) {
+        output += static_cast<char>(0xE0 | (ch >> 12));
+        output += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        output += static_cast<char>(0x80 | (ch & 0x3F));
+    } else {
+        output += static_cast<char>(0xF0 | (ch >> 18));
+        output += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+        output += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        output += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+}
+
+} // namespace
+
+
+TerminalScreen::TerminalScreen(unsigned width, unsigned height, int fd) :
+    m_fd {fd}
+{
+    resize(width, height);
+}
+
+std::pair<unsigned, unsigned> TerminalScreen::getTerminalSize(int fd)
+{
+    winsize windowSize {};
+    if (::ioctl(fd, TIOCGWINSZ, &windowSize) != 0) {
+        return {0, 0};
+    }
+    return {windowSize.ws_col, windowSize.ws_row};
+}
+
+unsigned TerminalScreen::getWidth() const
+{
+    return m_width;
+}
+
+unsigned TerminalScreen::getHeight() const
+{
+    return m_height;
+}
+
+void TerminalScreen::resize(unsigned width, unsigned height)
+{
+    std::vector<TerminalCell> backCells(std::size_t(width) * height);
+    for (unsigned y = 0; y < std::min(height, m_height); ++y) {
+        std::copy_n(m_backCells.begin() + std::size_t(y) * m_width, std::min(width, m_width),
+                    backCells.begin() + std::size_t(y) * width);
+    }
+    m_width = width;
+    m_height = height;
+    m_backCells = std::move(backCells);
+    m_frontCells.assign(m_backCells.size(), TerminalCell {});
+    invalidate();
+}
+
+void TerminalScreen::clear()
+{
+    std::fill(m_backCells.begin(), m_backCells.end(), TerminalCell {});
+}
+
+unsigned TerminalScreen::putText(unsigned x, unsigned y, std::string_view text, TerminalColor foreground, TerminalColor background, bool isBold)
+{
+    if (y >= m_height) {
+        return 0;
+    }
+    unsigned cellsCount {0};
+    for (std::size_t pos = 0; pos < text.size() && x + cellsCount < m_width; ++cellsCount) {
+        m_backCells[std::size_t(y) * m_width + x + cellsCount] = {toPrintable(decodeUtf8(text, pos)), foreground, background, isBold};
+    }
+    return cellsCount;
+}
+
+void TerminalScreen::setCell(unsigned x, unsigned y, const TerminalCell &cell)
+{
+    if (x < m_width && y < m_height) {
+        m_backCells[std::size_t(y) * m_width + x] = cell;
+        m_backCells[std::size_t(y) * m_width + x].ch = toPrintable(cell.ch);
+    }
+}
+
+const TerminalCell &TerminalScreen::getCell(unsigned x, unsigned y) const
+{
+    return m_backCells.at(std::size_t(y) * m_width + x);
+}
+
+bool TerminalScreen::present()
+{
+    m_output.clear();
+    if (m_isFullRedraw) {
+        m_output += "\x1b[0m\x1b[H\x1b[2J";
+        std::fill(m_frontCells.begin(), m_frontCells.end(), TerminalCell {});
+        m_attributes = {};
+        m_isAttributesKnown = true;
+        m_cursorX = 0;
+        m_cursorY = 0;
+        m_isCursorKnown = true;
+        m_isFullRedraw = false;
+    }
+
+    for (unsigned y = 0; y < m_height; ++y) {
+        auto pBack = m_backCells.data() + std::size_t(y) * m_width;
+        auto pFront = m_frontCells.data() + std::size_t(y) * m_width;
+        for (unsigned x = 0; x < m_width; ) {
+            if (pBack[x] == pFront[x]) {
+                ++x;
+                continue;
+            }
+
+            // Changed run, including short unchanged gaps
+            auto lastChanged = x;
+            for (auto i = x + 1; i < m_width && i - lastChanged <= MAX_REWRITTEN_GAP; ++i) {
+                if (pBack[i] != pFront[i]) {
+                    lastChanged = i;
+                }
+            }
+            moveCursor(x, y);
+            for (; x <= lastChanged; ++x) {
+                appendCell(pBack[x]);
+                pFront[x] = pBack[x];
+            }
+            m_cursorX = x;
+            if (m_cursorX >= m_width) {
+                m_isCursorKnown = false; // Terminals differ in wrap of last column
+            }
+        }
+    }
+    return writeOutput();
+}
+
+void TerminalScreen::invalidate()
+{
+    m_isFullRedraw = true;
+}
+
+std::pair<unsigned, unsigned> TerminalScreen::getCursorPosition() const
+{
+    return {m_cursorX, m_cursorY};
+}
+
+std::size_t TerminalScreen::getLastFrameSize() const
+{
+    return m_lastFrameSize;
+}
+
+void TerminalScreen::moveCursor(unsigned x, unsigned y)
+{
+    if (m_isCursorKnown && y == m_cursorY && x == m_cursorX) {
+        return;
+    }
+
+    if (m_isCursorKnown && y == m_cursorY && x > m_cursorX) {
+        m_output += "\x1b[";
+        if (x - m_cursorX > 1) {
+            m_output += std::to_string(x - m_cursorX);
+        }
+        m_output += 'C';
+    } else if (m_isCursorKnown && y == m_cursorY && x == 0) {
+        m_output += '\r';
+    } else if (m_isCursorKnown && y == m_cursorY + 1 && x == 0) {
+        m_output += "\r\n";
+    } else {
+        m_output += "\x1b[";
+        m_output += std::to_string(y + 1);
+        m_output += ';';
+        m_output += std::to_string(x + 1);
+        m_output += 'H';
+    }
+    m_cursorX = x;
+    m_cursorY = y;
+    m_isCursorKnown = true;
+}
+
+void TerminalScreen::setAttributes(const TerminalCell &cell)
+{
+    if (m_isAttributesKnown && m_attributes.foreground == cell.foreground &&
+        m_attributes.background == cell.background && m_attributes.isBold == cell.isBold) {
+        return;
+    }
+
+    m_output += "\x1b[0";
+    if (cell.isBold) {
+        m_output += ";1";
+    }
+    if (cell.foreground != TerminalColor::Default) {
+        m_output += ";3";
+        m_output += static_cast<char>('0' + static_cast<int>(cell.foreground) - 1);
+    }
+    if (cell.background != TerminalColor::Default) {
+        m_output += ";4";
+        m_output += static_cast<char>('0' + static_cast<int>(cell.background) - 1);
+    }
+    m_output += 'm';
+    m_attributes = cell;
+    m_isAttributesKnown = true;
+}
+
+void TerminalScreen::appendCell(const TerminalCell &cell)
+{
+    setAttributes(cell);
+    appendUtf8(m_output, cell.ch);
+}
+
+bool TerminalScreen::writeOutput()
+{
+    m_lastFrameSize = m_output.size();
+    std::string_view output(m_output);
+    while (!output.empty()) {
+        auto written = ::write(m_fd, output.data(), output.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Terminal state is unknown now
+            m_isFullRedraw = true;
+            m_isCursorKnown = false;
+            m_isAttributesKnown = false;
+            return false;
+        }
+        output.remove_prefix(written);
+    }
+    return true;
+}
+
+} // namespace Common
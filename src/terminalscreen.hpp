@@ -0,0 +1,129 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace Common {
+
+/**
+ * @brief The TerminalColor enum ANSI terminal colors
+ */
+enum class TerminalColor : uint8_t
+{
+    Default = 0,
+    Black,
+    Red,
+    Green,
+    Yellow,
+    Blue,
+    Magenta,
+    Cyan,
+    White,
+};
+
+/**
+ * @brief The TerminalCell struct One character cell of @ref TerminalScreen
+ */
+struct TerminalCell
+{
+    char32_t        ch {U' '};
+    TerminalColor   foreground {TerminalColor::Default};
+    TerminalColor   background {TerminalColor::Default};
+    bool            isBold {false};
+
+    bool operator==(const TerminalCell& other) const {
+        return (ch == other.ch && foreground == other.foreground && background == other.background && isBold == other.isBold);
+    }
+    bool operator!=(const TerminalCell& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief The TerminalScreen class Double-buffered terminal output
+ * @note Frame is drawn into back buffer, then @ref present() writes only changed cells, with one write(2).
+ *       Cursor position is tracked locally, terminal is never queried. Coordinates start from 0.
+ *       Every character is assumed to take one cell
+ */
+class TerminalScreen : public boost::noncopyable
+{
+public:
+    TerminalScreen(unsigned width, unsigned height, int fd = STDOUT_FILENO);
+
+    /**
+     * @brief getTerminalSize   Get size of terminal
+     * @return                  Width and height, {0, 0} if fd is not terminal
+     */
+    static std::pair<unsigned, unsigned> getTerminalSize(int fd = STDOUT_FILENO);
+
+    unsigned getWidth() const;
+    unsigned getHeight() const;
+
+    /**
+     * @brief resize    Change size of buffers. Next frame redraws whole screen
+     */
+    void resize(unsigned width, unsigned height);
+
+    /**
+     * @brief clear Fill back buffer with spaces
+     */
+    void clear();
+
+    /**
+     * @brief putText   Write UTF-8 text into back buffer. Text beyond right border is cut.
+     *                  Control characters (C0, DEL and C1) are written as U+FFFD, same for cells of setCell()
+     * @return          Count of cells written
+     */
+    unsigned putText(unsigned x, unsigned y, std::string_view text, TerminalColor foreground = TerminalColor::Default,
+                     TerminalColor background = TerminalColor::Default, bool isBold = false);
+    void setCell(unsigned x, unsigned y, const TerminalCell& cell);
+    const TerminalCell& getCell(unsigned x, unsigned y) const;
+
+    /**
+     * @brief present   Write difference between back and front buffers to terminal
+     * @return          false if write failed. Screen is redrawn completely on next frame then
+     */
+    bool present();
+
+    /**
+     * @brief invalidate    Redraw whole screen on next @ref present()
+     */
+    void invalidate();
+
+    /**
+     * @brief getCursorPosition Cached position of cursor after last frame, {x, y}
+     */
+    std::pair<unsigned, unsigned> getCursorPosition() const;
+    std::size_t getLastFrameSize() const;
+
+private:
+    int                         m_fd;
+    unsigned                    m_width {0};
+    unsigned                    m_height {0};
+    std::vector<TerminalCell>   m_frontCells;   // What terminal shows
+    std::vector<TerminalCell>   m_backCells;    // Next frame
+    bool                        m_isFullRedraw {true};
+    std::string                 m_output;
+    std::size_t                 m_lastFrameSize {0};
+
+    // Terminal state, known from previous output
+    unsigned                    m_cursorX {0};
+    unsigned                    m_cursorY {0};
+    bool                        m_isCursorKnown {false};
+    TerminalCell                m_attributes;       // Only colors and bold are used
+    bool                        m_isAttributesKnown {false};
+
+    void moveCursor(unsigned x, unsigned y);
+    void setAttributes(const TerminalCell& cell);
+    void appendCell(const TerminalCell& cell);
+    bool writeOutput();
+};
+
+} // namespace Common
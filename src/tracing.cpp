@@ -0,0 +1,208 @@
+#include "tracing.hpp"
+
+#include "atomicfilewriter.hpp"
+
+#include <Components/Logger/Logger.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+constexpr const char* TRACE_FILE_VARIABLE {"COMMON_TRACE_FILE"};
+
+void appendJsonString(std::string& output, const char* pText) {
+    output += '"';
+    for (; *pText; ++pText) {
+        auto ch = static_cast<unsigned char>(*pText);
+        if (ch == '"' || ch == '\\') {
+            output += '\\';
+            output += static_cast<char>(ch);
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            output += escaped;
+        } else {
+            output += static_cast<char>(ch);
+        }
+    }
+    output += '"';
+}
+
+void appendMicroseconds(std::string& output, uint64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                  static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+    output += buffer;
+}
+
+// Constructs tracer at startup, so that COMMON_TRACE_FILE enables tracing before first span
+const bool isTracerInitialized = (Tracer::getInstance(), true);
+
+} // namespace
+
+
+Tracer::Tracer()
+{
+    // Writer must outlive tracer for export at exit
+    AtomicFileWriter::getInstance();
+    if (auto pFilePath = std::getenv(TRACE_FILE_VARIABLE); pFilePath && *pFilePath) {
+        m_exitExportPath = pFilePath;
+        setEnabled(true);
+    }
+}
+
+Tracer::~Tracer()
+{
+    if (!m_exitExportPath.empty()) {
+        exportChromeTrace(m_exitExportPath);
+    }
+}
+
+Tracer &Tracer::getInstance()
+{
+    static Tracer inst;
+    return inst;
+}
+
+void Tracer::setEnabled(bool isEnabled)
+{
+    s_isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+void Tracer::setExitExportPath(const std::filesystem::path &filePath)
+{
+    std::lock_guard lock(m_buffersMx);
+    m_exitExportPath = filePath;
+}
+
+uint64_t Tracer::getNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(const TraceEvent &event)
+{
+    auto& buffer = getThreadBuffer();
+    if (buffer.eventsCount >= m_threadCapacity.load(std::memory_order_relaxed)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ++buffer.eventsCount;
+    auto pChunk = buffer.pLastChunk;
+    auto count = pChunk->count.load(std::memory_order_relaxed);
+    if (count == CHUNK_SIZE) {
+        buffer.chunks.push_back(std::make_unique<Chunk>());
+        auto pNewChunk = buffer.chunks.back().get();
+        pChunk->pNext.store(pNewChunk, std::memory_order_release);
+        buffer.pLastChunk = pNewChunk;
+        pChunk = pNewChunk;
+        count = 0;
+    }
+    pChunk->events[count] = event;
+    pChunk->count.store(count + 1, std::memory_order_release);
+}
+
+std::vector<TraceEvent> Tracer::getEvents() const
+{
+    std::vector<TraceEvent> res;
+    forEachEvent([&res](int, const TraceEvent& event) {
+        res.push_back(event);
+    });
+    return res;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard lock(m_buffersMx);
+    for (auto& pBuffer : m_buffers) {
+        pBuffer->isCleared.store(true, std::memory_order_relaxed);
+    }
+    m_buffers.clear();
+    m_droppedCount.store(0, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadCapacity(std::size_t capacity)
+{
+    m_threadCapacity.store(capacity, std::memory_order_relaxed);
+}
+
+std::size_t Tracer::getThreadCapacity() const
+{
+    return m_threadCapacity.load(std::memory_order_relaxed);
+}
+
+uint64_t Tracer::getDroppedCount() const
+{
+    return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+std::string Tracer::toChromeTrace() const
+{
+    std::string res = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    auto processId = std::to_string(::getpid());
+    bool isFirst {true};
+    forEachEvent([&](int threadId, const TraceEvent& event) {
+        res += (isFirst ? "\n{\"name\":" : ",\n{\"name\":");
+        isFirst = false;
+        appendJsonString(res, event.name);
+        res += ",\"cat\":";
+        appendJsonString(res, event.category);
+        res += ",\"ph\":\"X\",\"ts\":";
+        appendMicroseconds(res, event.startNs);
+        res += ",\"dur\":";
+        appendMicroseconds(res, event.durationNs);
+        res += ",\"pid\":" + processId + ",\"tid\":" + std::to_string(threadId) + "}";
+    });
+    res += "\n]}\n";
+    return res;
+}
+
+bool Tracer::exportChromeTrace(const std::filesystem::path &filePath) const
+{
+    if (!AtomicFileWriter::getInstance().writeFile(filePath, toChromeTrace(), Durability::None)) {
+        COMPLOG_ERROR("Tracer: failed to export trace:", filePath.string());
+        return false;
+    }
+    return true;
+}
+
+Tracer::ThreadBuffer &Tracer::getThreadBuffer()
+{
+    // Tracer keeps buffer after thread exit until clear(), cleared buffer is freed by last owner
+    thread_local std::shared_ptr<ThreadBuffer> pThreadBuffer;
+    if (!pThreadBuffer || pThreadBuffer->isCleared.load(std::memory_order_relaxed)) {
+        auto pBuffer = std::make_shared<ThreadBuffer>();
+        pBuffer->threadId = static_cast<int>(::syscall(SYS_gettid));
+        std::lock_guard lock(m_buffersMx);
+        m_buffers.push_back(pBuffer);
+        pThreadBuffer = std::move(pBuffer);
+    }
+    return *pThreadBuffer;
+}
+
+template <typename F>
+void Tracer::forEachEvent(F &&processor) const
+{
+    std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    {
+        std::lock_guard lock(m_buffersMx);
+        buffers = m_buffers;
+    }
+    for (auto& pBuffer : buffers) {
+        for (auto pChunk = &pBuffer->firstChunk; pChunk; pChunk = pChunk->pNext.load(std::memory_order_acquire)) {
+            auto count = pChunk->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) {
+                processor(pBuffer->threadId, pChunk->events[i]);
+            }
+        }
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define COMMON_TRACE_CONCAT_IMPL(a, b) a##b
+#define COMMON_TRACE_CONCAT(a, b) COMMON_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief COMMON_TRACE_SCOPE Record span from this line to the end of scope. Name must be string literal
+ */
+#define COMMON_TRACE_SCOPE(name) \
+    ::Common::TraceSpan COMMON_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+/**
+ * @brief COMMON_TRACE_FUNCTION Record span of current function
+ */
+#define COMMON_TRACE_FUNCTION() COMMON_TRACE_SCOPE(__PRETTY_FUNCTION__)
+
+namespace Common {
+
+/**
+ * @brief The TraceEvent struct Completed span
+ */
+struct TraceEvent
+{
+    const char* name;       // Static string
+    const char* category;   // Static string
+    uint64_t    startNs;    // Monotonic clock
+    uint64_t    durationNs;
+};
+
+/**
+ * @brief The Tracer class Collects spans into per-thread buffers and exports them as Chrome trace JSON
+ * @note Recording thread appends to own buffer and publishes it by release store, without locks.
+ *       Buffer of thread holds at most getThreadCapacity() spans, later ones are dropped until clear().
+ *       Tracing is enabled at startup if COMMON_TRACE_FILE environment variable is set,
+ *       trace is written to that file at exit then
+ */
+class Tracer : public boost::noncopyable
+{
+public:
+    ~Tracer();
+
+    static Tracer& getInstance();
+
+    static bool isEnabled() {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+    void setEnabled(bool isEnabled);
+
+    /**
+     * @brief setExitExportPath  Write trace to file at exit. Empty path disables export
+     */
+    void setExitExportPath(const std::filesystem::path& filePath);
+
+    /**
+     * @brief getNowNs   Monotonic time in nanoseconds
+     */
+    static uint64_t getNowNs();
+
+    /**
+     * @brief record    Add completed span of current thread
+     */
+    void record(const TraceEvent& event);
+
+    /**
+     * @brief getEvents  Copy of spans, recorded by all threads so far
+     */
+    std::vector<TraceEvent> getEvents() const;
+
+    /**
+     * @brief clear Remove recorded spans and reset dropped count. Buffers of exited threads are freed,
+     *              running thread replaces its buffer by new one on next span
+     */
+    void clear();
+
+    /**
+     * @brief setThreadCapacity  Max count of spans, kept per thread
+     */
+    void setThreadCapacity(std::size_t capacity);
+    std::size_t getThreadCapacity() const;
+
+    /**
+     * @brief getDroppedCount    Count of spans, dropped because buffer of thread was full
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief toChromeTrace  Trace in Chrome trace-event JSON format, loadable by Perfetto and chrome://tracing
+     */
+    std::string toChromeTrace() const;
+
+    /**
+     * @brief exportChromeTrace  Write trace to file
+     * @return                   false if file can't be written
+     */
+    bool exportChromeTrace(const std::filesystem::path& filePath) const;
+
+private:
+    static constexpr std::size_t CHUNK_SIZE {1024};
+    static constexpr std::size_t DEFAULT_THREAD_CAPACITY {std::size_t(1) << 20};
+
+    struct Chunk
+    {
+        TraceEvent              events[CHUNK_SIZE];
+        std::atomic<std::size_t> count {0};
+        std::atomic<Chunk*>     pNext {nullptr};
+    };
+
+    struct ThreadBuffer
+    {
+        int                                 threadId {0};
+        Chunk                               firstChunk;
+        Chunk*                              pLastChunk {&firstChunk};   // Owner thread only
+        std::vector<std::unique_ptr<Chunk> > chunks;                   // Owner thread only, keeps added chunks
+        std::size_t                         eventsCount {0};            // Owner thread only
+        std::atomic<bool>                   isCleared {false};          // Removed from tracer, owner must replace it
+    };
+
+    static inline std::atomic<bool>         s_isEnabled {false};
+
+    mutable std::mutex                      m_buffersMx;
+    std::vector<std::shared_ptr<ThreadBuffer> > m_buffers;         // Buffers outlive their threads until clear()
+    std::atomic<std::size_t>                m_threadCapacity {DEFAULT_THREAD_CAPACITY};
+    std::atomic<uint64_t>                   m_droppedCount {0};
+    std::filesystem::path                   m_exitExportPath;
+
+    Tracer();
+
+    ThreadBuffer& getThreadBuffer();
+
+    template <typename F>
+    void forEachEvent(F&& processor) const;
+};
+
+/**
+ * @brief The TraceSpan class Scoped span. If tracing is disabled, costs one relaxed load
+ */
+class TraceSpan : public boost::noncopyable
+{
+public:
+    explicit TraceSpan(const char* name, const char* category = "common") :
+        m_name {Tracer::isEnabled() ? name : nullptr},
+        m_category {category},
+        m_startNs {m_name ? Tracer::getNowNs() : 0}
+    {}
+    ~TraceSpan() {
+        if (m_name) {
+            Tracer::getInstance().record({m_name, m_category, m_startNs, Tracer::getNowNs() - m_startNs});
+        }
+    }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    uint64_t    m_startNs;
+};
+
+} // namespace Common
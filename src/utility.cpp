@@ -1,10 +1,24 @@
 #include "utility.hpp"
 
+#include "executor.hpp"
+#include "symbolizer.hpp"
+
 #include <stdexcept>
+#include <cctype>
+#include <ctime>
 #include <chrono>
+#include <cmath>
 #include <random>
 #include <iomanip>
 #include <sstream>
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <vector>
 
 #ifdef __linux__
 #include <signal.h>
@@ -15,32 +29,41 @@
 
 #include <cstring>
 
-#define BOOST_STACKTRACE_USE_ADDR2LINE
-#include <boost/stacktrace.hpp>
-#include <boost/core/demangle.hpp>
 
 #include <Components/Logger/Logger.h>
 
 namespace Common
 {
 
-void printStacktrace()
+static void logStacktrace(const std::vector<std::string>& frames)
 {
     COMPLOG_EMPTY_SYNC("STACK TRACE:");
     COMPLOG_EMPTY_SYNC("====================================================");
-    boost::stacktrace::stacktrace stackTrace;
     int traceLayer {0};
-    for (auto& line : stackTrace) {
-        COMPLOG_EMPTY_SYNC(traceLayer++, to_string(line));
+    for (auto& line : frames) {
+        COMPLOG_EMPTY_SYNC(traceLayer++, line);
     }
 
     COMPLOG_EMPTY_SYNC("====================================================");
 }
 
+void printStacktrace()
+{
+    logStacktrace(Symbolizer::getInstance().symbolize(CapturedStacktrace::capture(1)));
+}
+
+void printStacktraceDeferred()
+{
+    Symbolizer::getInstance().symbolizeAsync(CapturedStacktrace::capture(1), &logStacktrace);
+}
+
 void printStacktraceNoLogger()
 {
     std::cout << "================ STACK TRACE =================" << std::endl;
-    std::cout << boost::stacktrace::stacktrace() << std::endl;
+    int traceLayer {0};
+    for (auto& line : Symbolizer::getInstance().symbolize(CapturedStacktrace::capture(1))) {
+        std::cout << traceLayer++ << "# " << line << std::endl;
+    }
     std::cout << "==============================================" << std::endl;
 }
 
@@ -51,7 +74,7 @@ void processSignal(int signo) {
         return;
     }
     COMPLOG_ERROR_SYNC("SIGNAL:", signo, "(", strsignal(signo), ")");
-    printStacktrace();
+    logStacktrace(Symbolizer::getInstance().symbolizeNoWait(CapturedStacktrace::capture()));
     ::signal(signo, SIG_DFL);
 }
 
@@ -64,6 +87,7 @@ void setupBacktrace(std::function<bool (int)> &&signalProcessor)
 
 void setupBacktrace()
 {
+    Symbolizer::getInstance(); // Not created in signal handler
     ::signal(SIGSEGV, &processSignal);
     ::signal(SIGABRT, &processSignal);
     ::signal(SIGTERM, &processSignal);
@@ -151,18 +175,21 @@ std::pair<unsigned, unsigned> terminalGetXY()
 #endif // __linux__
 }
 
+static RandomStream& getThreadRandomStream()
+{
+    thread_local auto stream = RandomStream::fromEntropy();
+    return stream;
+}
+
 int createRandomNumber(int min, int max)
 {
     if (min >= max) throw std::invalid_argument("createRandomNumber: max >= min");
-    std::random_device rd;
-    std::mt19937 rng(rd());
     std::uniform_int_distribution<int> uni(min, max);
-    return uni(rng);
+    return uni(getThreadRandomStream());
 }
 
 std::string createRandomString(unsigned int stringLength) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    auto& gen = getThreadRandomStream();
 
     const std::string characters =
             "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
@@ -176,6 +203,310 @@ std::string createRandomString(unsigned int stringLength) {
     return result;
 }
 
+namespace {
+
+constexpr char      HEX_DIGITS[]        {"0123456789abcdef"};
+constexpr char      BASE32_DIGITS[]     {"0123456789ABCDEFGHJKMNPQRSTVWXYZ"};
+constexpr uint64_t  TAG_MASK            {(uint64_t(1) << 48) - 1};
+
+struct UniqueIdState
+{
+    uint64_t lastMs {0};
+    uint32_t sequence {0};
+    uint64_t tag {0};
+};
+
+uint64_t getCoarseTimeMs() {
+#ifdef __linux__
+    timespec now;
+    ::clock_gettime(CLOCK_REALTIME_COARSE, &now);
+    return uint64_t(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+#else
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+#endif // __linux__
+}
+
+/**
+ * @brief mixThreadTag  Bijection of 48-bit values, so distinct thread ordinals give distinct tags
+ */
+uint64_t mixThreadTag(uint64_t value) {
+    value &= TAG_MASK;
+    value ^= value >> 23;
+    value = (value * 0x9E3779B97F4Bull) & TAG_MASK; // Odd multiplier
+    value ^= value >> 21;
+    value = (value * 0xBF58476D1CE5ull) & TAG_MASK;
+    return value ^ (value >> 25);
+}
+
+UniqueIdState& getUniqueIdState() {
+    static const uint64_t processSalt = []() {
+        std::random_device rd;
+        return (uint64_t(rd()) << 32) ^ rd();
+    }();
+    static std::atomic<uint64_t> threadsCount {0};
+
+    thread_local UniqueIdState state = []() {
+        UniqueIdState res;
+        res.tag = mixThreadTag(processSalt + threadsCount.fetch_add(1, std::memory_order_relaxed));
+        res.sequence = static_cast<uint32_t>(processSalt >> 40); // Sequence is not guessable from ID count
+        return res;
+    }();
+    return state;
+}
+
+/**
+ * @brief nextUniqueId  Next ID of thread. Time is not allowed to go back, sequence overflow advances time
+ */
+UniqueId nextUniqueId(UniqueIdState& state, uint64_t nowMs) {
+    ++state.sequence;
+    if (nowMs > state.lastMs) {
+        state.lastMs = nowMs;
+    } else if (state.sequence == 0) {
+        ++state.lastMs;
+    }
+    return {(state.lastMs << 16) | (state.sequence >> 16),
+            (uint64_t(state.sequence & 0xFFFF) << 48) | state.tag};
+}
+
+} // namespace
+
+char *UniqueId::toHex(char *pOutput) const
+{
+    for (int i = 15; i >= 0; --i) {
+        *pOutput++ = HEX_DIGITS[(high >> (i * 4)) & 0xF];
+    }
+    for (int i = 15; i >= 0; --i) {
+        *pOutput++ = HEX_DIGITS[(low >> (i * 4)) & 0xF];
+    }
+    return pOutput;
+}
+
+char *UniqueId::toBase32(char *pOutput) const
+{
+    // 128 bits as 26 digits, first digit has 3 bits
+    for (int shift = 125; shift >= 0; shift -= 5) {
+        uint64_t bits;
+        if (shift >= 64) {
+            bits = high >> (shift - 64);
+        } else if (shift > 59) {
+            bits = (low >> shift) | (high << (64 - shift));
+        } else {
+            bits = low >> shift;
+        }
+        *pOutput++ = BASE32_DIGITS[bits & 0x1F];
+    }
+    return pOutput;
+}
+
+std::string UniqueId::toString() const
+{
+    std::string res(BASE32_LENGTH, '\0');
+    toBase32(res.data());
+    return res;
+}
+
+std::optional<UniqueId> UniqueId::fromBase32(std::string_view text)
+{
+    if (text.size() != BASE32_LENGTH) {
+        return std::nullopt;
+    }
+    UniqueId res;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto ch = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+        auto pDigit = std::strchr(BASE32_DIGITS, ch);
+        if (ch == '\0' || !pDigit || (i == 0 && pDigit - BASE32_DIGITS > 7)) {
+            return std::nullopt;
+        }
+        res.high = (res.high << 5) | (res.low >> 59);
+        res.low = (res.low << 5) | uint64_t(pDigit - BASE32_DIGITS);
+    }
+    return res;
+}
+
+UniqueId generateUniqueId()
+{
+    return nextUniqueId(getUniqueIdState(), getCoarseTimeMs());
+}
+
+void generateUniqueIds(UniqueId *pIds, std::size_t count)
+{
+    auto& state = getUniqueIdState();
+    auto nowMs = getCoarseTimeMs();
+    for (std::size_t i = 0; i < count; ++i) {
+        pIds[i] = nextUniqueId(state, nowMs);
+    }
+}
+
+namespace {
+
+constexpr uint32_t      PHILOX_M0           {0xD2511F53};
+constexpr uint32_t      PHILOX_M1           {0xCD9E8D57};
+constexpr uint32_t      PHILOX_W0           {0x9E3779B9};
+constexpr uint32_t      PHILOX_W1           {0xBB67AE85};
+constexpr int           PHILOX_ROUNDS       {10};
+constexpr std::size_t   PHILOX_BATCH        {8};    // Blocks, processed together. Loops over them are vectorized
+constexpr std::size_t   FILL_CHUNK_WORDS    {256};
+constexpr uint32_t      SPLIT_KEY_MASK[2]   {0x5851F42D, 0x4C957F2D};   // Separates split domain from output
+
+/**
+ * @brief philoxBatch   Generate blocks [firstBlock, firstBlock + PHILOX_BATCH) of stream
+ * @param pWords        Output, 2 words per block
+ */
+void philoxBatch(const uint32_t key[2], uint64_t streamId, uint64_t firstBlock, uint64_t* pWords)
+{
+    uint32_t c0[PHILOX_BATCH], c1[PHILOX_BATCH], c2[PHILOX_BATCH], c3[PHILOX_BATCH];
+    for (std::size_t i = 0; i < PHILOX_BATCH; ++i) {
+        auto block = firstBlock + i;
+        c0[i] = static_cast<uint32_t>(block);
+        c1[i] = static_cast<uint32_t>(block >> 32);
+        c2[i] = static_cast<uint32_t>(streamId);
+        c3[i] = static_cast<uint32_t>(streamId >> 32);
+    }
+    auto k0 = key[0];
+    auto k1 = key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        // Complete unrolling of lanes hides the loop from vectorizer
+#pragma GCC unroll 1
+        for (std::size_t i = 0; i < PHILOX_BATCH; ++i) {
+            auto p0 = uint64_t(PHILOX_M0) * c0[i];
+            auto p1 = uint64_t(PHILOX_M1) * c2[i];
+            c0[i] = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+            c1[i] = static_cast<uint32_t>(p1);
+            c2[i] = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+            c3[i] = static_cast<uint32_t>(p0);
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (std::size_t i = 0; i < PHILOX_BATCH; ++i) {
+        pWords[2 * i] = c0[i] | (uint64_t(c1[i]) << 32);
+        pWords[2 * i + 1] = c2[i] | (uint64_t(c3[i]) << 32);
+    }
+}
+
+inline double toUnitReal(uint64_t word)
+{
+    return static_cast<double>(word >> 11) * 0x1p-53;
+}
+
+} // namespace
+
+RandomStream::RandomStream(uint64_t seed, uint64_t streamId) :
+    m_key {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+    m_streamId {streamId}
+{
+
+}
+
+RandomStream RandomStream::fromEntropy()
+{
+    std::random_device rd;
+    auto seed = (uint64_t(rd()) << 32) | rd();
+    auto streamId = (uint64_t(rd()) << 32) | rd();
+    return RandomStream(seed, streamId);
+}
+
+RandomStream RandomStream::split(uint64_t childId) const
+{
+    const uint32_t key[2] {m_key[0] ^ SPLIT_KEY_MASK[0], m_key[1] ^ SPLIT_KEY_MASK[1]};
+    uint64_t words[2 * PHILOX_BATCH];
+    philoxBatch(key, m_streamId, childId, words);
+    return RandomStream(words[0], words[1]);
+}
+
+RandomStream::result_type RandomStream::operator()()
+{
+    if (m_position < m_cachedPosition || m_position - m_cachedPosition >= CACHED_WORDS_COUNT) {
+        m_cachedPosition = m_position & ~uint64_t(1);
+        generateWords(m_cachedPosition, m_cachedWords, CACHED_WORDS_COUNT);
+    }
+    return m_cachedWords[m_position++ - m_cachedPosition];
+}
+
+void RandomStream::seek(uint64_t position)
+{
+    m_position = position;
+}
+
+uint64_t RandomStream::getPosition() const
+{
+    return m_position;
+}
+
+void RandomStream::fillUniformInt(int32_t *pOutput, std::size_t count, int32_t min, int32_t max)
+{
+    if (min > max) throw std::invalid_argument("RandomStream::fillUniformInt: min > max");
+    uint64_t words[FILL_CHUNK_WORDS];
+    auto range = static_cast<uint64_t>(int64_t(max) - min + 1);
+    for (std::size_t done = 0; done < count; ) {
+        auto chunkSize = std::min(count - done, FILL_CHUNK_WORDS);
+        generateWords(m_position, words, chunkSize);
+        for (std::size_t i = 0; i < chunkSize; ++i) {
+            // Multiply-shift instead of rejection: each value takes exactly one word
+            auto offset = static_cast<uint64_t>((static_cast<unsigned __int128>(words[i]) * range) >> 64);
+            pOutput[done + i] = static_cast<int32_t>(min + static_cast<int64_t>(offset));
+        }
+        m_position += chunkSize;
+        done += chunkSize;
+    }
+}
+
+void RandomStream::fillUniformReal(double *pOutput, std::size_t count, double min, double max)
+{
+    uint64_t words[FILL_CHUNK_WORDS];
+    auto scale = max - min;
+    for (std::size_t done = 0; done < count; ) {
+        auto chunkSize = std::min(count - done, FILL_CHUNK_WORDS);
+        generateWords(m_position, words, chunkSize);
+        for (std::size_t i = 0; i < chunkSize; ++i) {
+            pOutput[done + i] = min + toUnitReal(words[i]) * scale;
+        }
+        m_position += chunkSize;
+        done += chunkSize;
+    }
+}
+
+void RandomStream::fillNormal(double *pOutput, std::size_t count, double mean, double stddev)
+{
+    // Pair of values is generated from words at even position and next one, value at even position
+    // takes cosine. So value doesn't depend on where array starts
+    uint64_t words[FILL_CHUNK_WORDS];
+    auto endPosition = m_position + count;
+    auto position = m_position & ~uint64_t(1);
+    while (position < endPosition) {
+        auto chunkSize = std::min<uint64_t>((endPosition - position + 1) & ~uint64_t(1), FILL_CHUNK_WORDS);
+        generateWords(position, words, chunkSize);
+        for (std::size_t i = 0; i < chunkSize; i += 2, position += 2) {
+            auto radius = stddev * std::sqrt(-2.0 * std::log(1.0 - toUnitReal(words[i])));
+            auto angle = 2.0 * M_PI * toUnitReal(words[i + 1]);
+            if (position >= m_position) {
+                pOutput[position - m_position] = mean + radius * std::cos(angle);
+            }
+            if (position + 1 < endPosition) {
+                pOutput[position + 1 - m_position] = mean + radius * std::sin(angle);
+            }
+        }
+    }
+    m_position = endPosition;
+}
+
+void RandomStream::generateWords(uint64_t firstPosition, uint64_t *pWords, std::size_t count) const
+{
+    uint64_t batchWords[2 * PHILOX_BATCH];
+    auto endPosition = firstPosition + count;
+    for (auto position = firstPosition; position < endPosition; ) {
+        auto firstBlock = position / 2;
+        auto batchEnd = std::min(endPosition, (firstBlock + PHILOX_BATCH) * 2);
+        if (position % 2 == 0 && batchEnd - position == 2 * PHILOX_BATCH) {
+            philoxBatch(m_key, m_streamId, firstBlock, pWords + (position - firstPosition));
+        } else {
+            philoxBatch(m_key, m_streamId, firstBlock, batchWords);
+            std::copy(batchWords + position % 2, batchWords + position % 2 + (batchEnd - position), pWords + (position - firstPosition));
+        }
+        position = batchEnd;
+    }
+}
+
 uint64_t getEpoch()
 {
     auto now = std::chrono::system_clock::now();
@@ -200,4 +531,53 @@ std::string getCurrentTimestampFormatted() {
     return oss.str();
 }
 
+bool forEachParallel(std::size_t count, unsigned workersCount, const std::function<bool (std::size_t)> &processor)
+{
+    // Tasks may start after current thread processed all items, so state outlives this call
+    struct State
+    {
+        std::atomic<std::size_t>    nextIndex {0};
+        std::atomic<bool>           isFailed {false};
+        std::mutex                  mx;
+        std::condition_variable     cv;
+        std::size_t                 runningCount {0};
+        bool                        isClosed {false};   // Not started tasks must not touch processor
+    };
+    auto pState = std::make_shared<State>();
+    auto worker = [pState, count, &processor]() {
+        for (auto i = pState->nextIndex++; i < count && !pState->isFailed.load(std::memory_order_relaxed); i = pState->nextIndex++) {
+            if (!processor(i)) {
+                pState->isFailed = true;
+            }
+        }
+    };
+
+    // Current thread processes items too, so it does not wait for tasks, which are not started.
+    // This also works when it is worker of busy executor
+    auto tasksCount = std::min<std::size_t>(std::max(workersCount, 1u), count);
+    for (std::size_t i = 1; i < tasksCount; ++i) {
+        Executor::getInstance().post([pState, worker]() {
+            {
+                std::lock_guard lock(pState->mx);
+                if (pState->isClosed) {
+                    return;
+                }
+                ++pState->runningCount;
+            }
+            worker();
+            std::lock_guard lock(pState->mx);
+            --pState->runningCount;
+            pState->cv.notify_all();
+        });
+    }
+    worker();
+
+    std::unique_lock lock(pState->mx);
+    pState->isClosed = true;
+    pState->cv.wait(lock, [&pState]() {
+        return (pState->runningCount == 0);
+    });
+    return !pState->isFailed;
+}
+
 }
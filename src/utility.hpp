@@ -1,12 +1,23 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <optional>
 #include <stdint.h>
 #include <functional>
 
 namespace Common {
 
+/**
+ * @brief printStacktrace   Log stack of current thread. Symbolized in process, repeated addresses are cached
+ */
 void printStacktrace();
+
+/**
+ * @brief printStacktraceDeferred   Capture stack now, symbolize and log it in background thread
+ * @note For error paths, which must not wait for symbolization
+ */
+void printStacktraceDeferred();
 void printStacktraceNoLogger();
 
 /**
@@ -37,7 +48,7 @@ void terminalGotoXY(int x,int y);
 std::pair<unsigned, unsigned> terminalGetXY();
 
 /**
- * @brief createRandomNumber    Generates number using MT19937
+ * @brief createRandomNumber    Generates number using thread local @ref RandomStream, seeded once per thread
  * @param min
  * @param max
  * @return
@@ -52,6 +63,139 @@ int createRandomNumber(int min, int max);
  */
 std::string createRandomString(unsigned int stringLength);
 
+/**
+ * @brief The UniqueId struct Time-ordered 128-bit ID (ULID layout)
+ * @note Bits: 48 - unix time in ms, 32 - per-thread sequence, 48 - thread tag.
+ *       IDs of one thread are strictly increasing, IDs of different threads are ordered by ms only.
+ *       Thread tags are distinct in process and randomized per process
+ */
+struct UniqueId
+{
+    static constexpr std::size_t HEX_LENGTH     {32};
+    static constexpr std::size_t BASE32_LENGTH  {26};
+
+    uint64_t high {0};
+    uint64_t low {0};
+
+    uint64_t getTimestampMs() const {
+        return high >> 16;
+    }
+
+    /**
+     * @brief toHex     Write lowercase hex without terminating zero
+     * @param pOutput   Buffer of at least HEX_LENGTH chars
+     * @return          Pointer past written chars
+     */
+    char* toHex(char* pOutput) const;
+
+    /**
+     * @brief toBase32  Write Crockford base32 (as ULID) without terminating zero
+     * @param pOutput   Buffer of at least BASE32_LENGTH chars
+     * @return          Pointer past written chars
+     */
+    char* toBase32(char* pOutput) const;
+
+    /**
+     * @brief toString  Base32 representation
+     */
+    std::string toString() const;
+
+    /**
+     * @brief fromBase32    Parse base32 representation, case insensitive
+     * @return              std::nullopt if text is not valid ID
+     */
+    static std::optional<UniqueId> fromBase32(std::string_view text);
+
+    bool operator==(const UniqueId& other) const {
+        return (high == other.high && low == other.low);
+    }
+    bool operator!=(const UniqueId& other) const {
+        return !(*this == other);
+    }
+    bool operator<(const UniqueId& other) const {
+        return (high < other.high || (high == other.high && low < other.low));
+    }
+};
+
+/**
+ * @brief generateUniqueId  Generate ID without locks, using coarse clock and per-thread state
+ */
+UniqueId generateUniqueId();
+
+/**
+ * @brief generateUniqueIds Generate increasing IDs in bulk, clock is read once
+ * @param pIds              Output array
+ * @param count             Count of IDs
+ */
+void generateUniqueIds(UniqueId* pIds, std::size_t count);
+
+/**
+ * @brief The RandomStream class Counter-based generator (Philox4x32-10), seedable and splittable
+ * @note Value at position depends only on seed, stream and position, so results are reproducible
+ *       regardless of how work is divided between threads: give each task own stream by split(taskIndex)
+ *       or own range of positions by seek(). Each bulk value takes one 64-bit word at its position.
+ *       Satisfies UniformRandomBitGenerator, so can be used with std distributions
+ */
+class RandomStream
+{
+public:
+    using result_type = uint64_t;
+
+    explicit RandomStream(uint64_t seed = 0, uint64_t streamId = 0);
+
+    /**
+     * @brief fromEntropy   Stream with random seed from std::random_device, for non-reproducible use
+     */
+    static RandomStream fromEntropy();
+
+    /**
+     * @brief split     Derive independent stream. Same parent and childId give same child
+     * @param childId   Task or thread index, for example
+     */
+    RandomStream split(uint64_t childId) const;
+
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+    result_type operator()();
+
+    /**
+     * @brief seek      Set position (in 64-bit words) of next value
+     */
+    void seek(uint64_t position);
+    uint64_t getPosition() const;
+
+    /**
+     * @brief fillUniformInt    Fill array with integers from [min, max]. Bias of range reduction is below 2^-32
+     * @throws std::invalid_argument if min > max, position is not changed then
+     */
+    void fillUniformInt(int32_t* pOutput, std::size_t count, int32_t min, int32_t max);
+
+    /**
+     * @brief fillUniformReal   Fill array with reals from [min, max), 53 random bits each
+     */
+    void fillUniformReal(double* pOutput, std::size_t count, double min = 0.0, double max = 1.0);
+
+    /**
+     * @brief fillNormal        Fill array with normally distributed reals (Box-Muller on pairs of positions)
+     */
+    void fillNormal(double* pOutput, std::size_t count, double mean = 0.0, double stddev = 1.0);
+
+private:
+    static constexpr std::size_t CACHED_WORDS_COUNT {16};   // One batch of blocks
+
+    uint32_t m_key[2];
+    uint64_t m_streamId;
+    uint64_t m_position {0};
+    uint64_t m_cachedPosition {UINT64_MAX};     // Words, used by operator()
+    uint64_t m_cachedWords[CACHED_WORDS_COUNT] {};
+
+    void generateWords(uint64_t firstPosition, uint64_t* pWords, std::size_t count) const;
+};
+
 /**
  * @brief getEpoch Get epoch time in seconds (since 1 Jan 1970)
  * @return
@@ -64,4 +208,13 @@ uint64_t getEpoch();
  */
 std::string getCurrentTimestampFormatted();
 
+/**
+ * @brief forEachParallel   Call processor for indexes [0, count) in current thread and tasks of Executor::getInstance()
+ * @param count             Count of items
+ * @param workersCount      Max count of parallel workers, including current thread
+ * @param processor         Item processor, returns false on error
+ * @return                  false if any processor failed. Remaining items are skipped in this case
+ */
+bool forEachParallel(std::size_t count, unsigned workersCount, const std::function<bool(std::size_t)>& processor);
+
 }
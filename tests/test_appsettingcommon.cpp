@@ -2,6 +2,21 @@
 
 #include <Components/Ecosystem/ApplicationSettings.h>
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+#include <Components/Ecosystem/SettingsItemModel.h>
+
+#include <QCoreApplication>
+#endif // COMPONENTS_IS_ENABLED_QT
+
+#include <sys/wait.h>
+#include <unistd.h>
+
 using namespace Common;
 
 void checkSettingBasics(AppSetting& sett) {
@@ -48,4 +63,531 @@ TEST(AppSettings, NumericSetting) {
         ASSERT_FALSE(sett.setValue(300.002));
         ASSERT_EQ(sett.getValueString(), "300.000000");
     }
-}
\ No newline at end of file
+}
+TEST(AppSettings, Layers) {
+    auto& settings = ApplicationSettings::getInstance();
+    settings.addSetting("layers", "base")->setValue(int64_t(1));
+    settings.addSetting("layers", "overridden")->setValue(int64_t(1));
+
+    ASSERT_TRUE(settings.pushLayer("host"));
+    ASSERT_TRUE(settings.pushLayer("env"));
+    ASSERT_FALSE(settings.pushLayer("host"));
+
+    settings.setLayerValue("host", "layers", "overridden", int64_t(2));
+    settings.setLayerValue("host", "layers", "hostOnly", "host");
+    ASSERT_EQ(settings.getSetting("layers", "overridden")->getValue<int64_t>(), 2);
+    ASSERT_EQ(settings.getSetting("layers", "hostOnly")->getValueString(), "host");
+    ASSERT_EQ(settings.getSetting("layers", "base")->getValue<int64_t>(), 1);
+
+    setenv("LAYERSTEST_layers__overridden", "3", 1);
+    ASSERT_TRUE(settings.loadLayerEnvironment("env", "LAYERSTEST_"));
+    ASSERT_EQ(settings.getSetting("layers", "overridden")->getValue<int64_t>(), 3);
+    ASSERT_EQ(settings.getSettingSource("layers", "overridden"), "env");
+
+    settings.clearLayer("env");
+    ASSERT_EQ(settings.getSetting("layers", "overridden")->getValue<int64_t>(), 2);
+
+    // Layer values are checked by bounds of base setting
+    auto pBounded = std::make_shared<AppIntSetting>();
+    pBounded->setName("bounded");
+    pBounded->setMax(10);
+    pBounded->setValue(int64_t(1));
+    settings.addSetting("layers", pBounded);
+    settings.setLayerValue("host", "layers", "bounded", int64_t(50));
+    ASSERT_EQ(settings.getSetting("layers", "bounded"), pBounded);
+    setenv("LAYERSTEST_layers__bounded", "7", 1);
+    ASSERT_TRUE(settings.loadLayerEnvironment("env", "LAYERSTEST_"));
+    ASSERT_EQ(settings.getSetting("layers", "bounded")->getValue<int64_t>(), 7);
+    ASSERT_EQ(settings.getSettingSource("layers", "bounded"), "env");
+
+    // Transaction changes base setting by its rules, layer value stays effective
+    auto transaction = settings.beginTransaction();
+    transaction.setValue("layers", "bounded", int64_t(500));
+    ASSERT_FALSE(transaction.commit());
+    ASSERT_EQ(settings.getSetting("layers", "bounded")->getValue<int64_t>(), 7);
+    transaction.setValue("layers", "bounded", int64_t(9));
+    ASSERT_TRUE(transaction.commit());
+    ASSERT_EQ(pBounded->getValue<int64_t>(), 9);
+    ASSERT_EQ(settings.getSetting("layers", "bounded")->getValue<int64_t>(), 7);
+    transaction.removeSetting("layers", "hostOnly"); // Only in layer, base is not changed
+    ASSERT_TRUE(transaction.commit());
+    ASSERT_EQ(settings.getSetting("layers", "hostOnly")->getValueString(), "host");
+    settings.clearLayer("env");
+    ASSERT_EQ(settings.getSetting("layers", "bounded"), pBounded);
+    ASSERT_TRUE(settings.removeSetting("layers", "bounded"));
+    ASSERT_EQ(settings.getSetting("layers", "bounded")->getValue<int64_t>(), 50);
+
+    ASSERT_TRUE(settings.removeLayer("host"));
+    ASSERT_EQ(settings.getSetting("layers", "overridden")->getValue<int64_t>(), 1);
+    ASSERT_FALSE(settings.hasSetting("layers", "hostOnly"));
+    ASSERT_FALSE(settings.hasSetting("layers", "bounded"));
+    ASSERT_TRUE(settings.removeLayer("env"));
+}
+
+TEST(AppSettings, SharedSegment) {
+    auto& settings = ApplicationSettings::getInstance();
+    settings.addSetting("shared", "workers")->setValue(int64_t(8));
+    settings.addSetting("shared", "ratio")->setValue(0.5);
+    settings.addSetting("shared", "name")->setValue("worker");
+
+    const std::string segmentName = "/common-test-" + std::to_string(getpid());
+    SharedSettingsSegment publisher;
+    ASSERT_TRUE(publisher.create(segmentName));
+    ASSERT_TRUE(publisher.publish(settings));
+    ASSERT_EQ(publisher.getGeneration(), 1);
+
+    std::vector<pid_t> workers;
+    for (int i = 0; i < 4; ++i) {
+        auto pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            // Child must not return into test framework on any path
+            int exitCode {1};
+            try {
+                SharedSettingsSegment reader;
+                bool isOk = reader.open(segmentName) &&
+                            std::get<int64_t>(reader.getValue("shared", "workers")) == 8 &&
+                            std::get<double>(reader.getValue("shared", "ratio")) == 0.5 &&
+                            reader.readValue("shared", "name", [](const SharedValueView& view) {
+                                return (view.getString() == "worker");
+                            }) &&
+                            !reader.hasSetting("shared", "missing");
+                exitCode = (isOk ? 0 : 1);
+            } catch (...) {
+            }
+            _exit(exitCode);
+        }
+        workers.push_back(pid);
+    }
+    for (auto pid : workers) {
+        int status {0};
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    SharedSettingsSegment reader;
+    ASSERT_TRUE(reader.open(segmentName));
+    settings.getSetting("shared", "workers")->setValue(int64_t(16));
+    ASSERT_TRUE(publisher.publish(settings));
+    ASSERT_EQ(reader.getGeneration(), 2);
+    ASSERT_EQ(std::get<int64_t>(reader.getValue("shared", "workers")), 16);
+}
+
+TEST(AppSettings, PrefixAndGlobQueries) {
+    ASSERT_TRUE(SettingsIndex::isGlobMatch("cache.redis.size", "cache.*.size"));
+    ASSERT_FALSE(SettingsIndex::isGlobMatch("cache.redis.local.size", "cache.*.size"));
+    ASSERT_TRUE(SettingsIndex::isGlobMatch("cache.redis.local.size", "cache.**.size"));
+    ASSERT_TRUE(SettingsIndex::isGlobMatch("a.b.c.size", "**.*.size"));
+    ASSERT_TRUE(SettingsIndex::isGlobMatch("plugins.x1", "plugins.x?"));
+
+    auto& settings = ApplicationSettings::getInstance();
+    settings.addSetting("plugins", "b")->setValue("2");
+    settings.addSetting("plugins", "a")->setValue("1");
+    settings.addSetting("plugins-extra", "c")->setValue("3");
+    settings.addSetting("cache", "redis.size")->setValue(int64_t(10));
+    settings.addSetting("cache", "redis.ttl")->setValue(int64_t(20));
+    settings.addSetting("cache", "local.size")->setValue(int64_t(30));
+
+    std::vector<std::string> keys;
+    for (auto& [fullKey, entry] : settings.findSettingsByPrefix("plugins.")) {
+        keys.push_back(fullKey);
+    }
+    ASSERT_EQ(keys, (std::vector<std::string> {"plugins.a", "plugins.b"}));
+
+    keys.clear();
+    for (auto& [fullKey, entry] : settings.findSettings("cache.*.size")) {
+        ASSERT_EQ(entry.section, "cache");
+        keys.push_back(fullKey);
+    }
+    ASSERT_EQ(keys, (std::vector<std::string> {"cache.local.size", "cache.redis.size"}));
+    ASSERT_TRUE(settings.findSettings("cache.*.missing").empty());
+
+    // Setting with taken name replaces previous one
+    auto pReplacement = settings.addSetting("plugins", "a");
+    pReplacement->setValue("replaced");
+    ASSERT_EQ(settings.getSetting("plugins", "a"), pReplacement);
+    auto pluginsRange = settings.findSettingsByPrefix("plugins.");
+    ASSERT_EQ(std::distance(pluginsRange.begin(), pluginsRange.end()), 2);
+}
+
+TEST(AppSettings, ChangeNotifications) {
+    auto& settings = ApplicationSettings::getInstance();
+    auto& notifier = settings.getNotifier();
+    auto pTimeout = settings.addSetting("notify", "timeout");
+    auto pRetries = settings.addSetting("notify", "retries");
+    settings.addSetting("notify-other", "value");
+
+    std::vector<std::vector<SettingChange> > keyBatches;
+    auto keyId = notifier.subscribe("notify.timeout", [&keyBatches](const std::vector<SettingChange>& changes) {
+        keyBatches.push_back(changes);
+    });
+    std::size_t sectionChanges {0};
+    auto sectionId = notifier.subscribe("notify.*", [&sectionChanges](const std::vector<SettingChange>& changes) {
+        sectionChanges += changes.size();
+    });
+    std::atomic<std::size_t> queuedChanges {0};
+    auto queuedId = notifier.subscribe("**", [&queuedChanges](const std::vector<SettingChange>& changes) {
+        queuedChanges += changes.size();
+    }, SettingsNotifier::DeliveryMode::Queued);
+
+    pTimeout->setValue(int64_t(5));
+    ASSERT_EQ(keyBatches.size(), 1);
+    ASSERT_EQ(std::get<int64_t>(keyBatches[0][0].value), 5);
+
+    {
+        SettingsNotifier::Batch batch(notifier);
+        pTimeout->setValue(int64_t(6));
+        pRetries->setValue(int64_t(3));
+        settings.getSetting("notify-other", "value")->setValue("x");
+        ASSERT_EQ(keyBatches.size(), 1);
+    }
+    ASSERT_EQ(keyBatches.size(), 2);
+    ASSERT_EQ(sectionChanges, 3);
+
+    notifier.waitDelivered();
+    ASSERT_EQ(queuedChanges, 4);
+
+    notifier.unsubscribe(keyId);
+    notifier.unsubscribe(sectionId);
+    notifier.unsubscribe(queuedId);
+    pTimeout->setValue(int64_t(7));
+    ASSERT_EQ(keyBatches.size(), 2);
+}
+
+TEST(AppSettings, ReloadNotifications) {
+    auto& settings = ApplicationSettings::getInstance();
+    auto configPath = (std::filesystem::temp_directory_path() / ("common_reload_" + std::to_string(getpid()) + ".ini")).string();
+    std::ofstream(configPath) << "[reload]\nkeep=1\ngone=2\nchanged=3\n";
+    settings.loadSettings(configPath);
+
+    std::map<std::string, AppSettingValue_t> changes;
+    auto subscriptionId = settings.getNotifier().subscribe("reload.*", [&changes](const std::vector<SettingChange>& batch) {
+        for (auto& change : batch) {
+            changes[change.name] = change.value;
+        }
+    });
+    std::ofstream(configPath) << "[reload]\nkeep=1\nchanged=4\nadded=5\n";
+    settings.loadSettings(configPath);
+    settings.getNotifier().unsubscribe(subscriptionId);
+    std::filesystem::remove(configPath);
+
+    // Unchanged value is not reported, removed one is reported as empty
+    ASSERT_EQ(changes.size(), 3);
+    ASSERT_EQ(changes.count("keep"), 0);
+    ASSERT_TRUE(std::holds_alternative<std::monostate>(changes["gone"]));
+    ASSERT_EQ(std::get<int64_t>(changes["changed"]), 4);
+    ASSERT_EQ(std::get<int64_t>(changes["added"]), 5);
+}
+
+// Setting, which accepts value on check and rejects it on apply
+class ApplyRejectingSetting : public AppSetting
+{
+public:
+    bool setValue(const AppSettingValue_t& v) override {
+        auto pText = std::get_if<std::string>(&v);
+        return ((!pText || *pText != "reject") && AppSetting::setValue(v));
+    }
+};
+
+TEST(AppSettings, TransactionsAndHistory) {
+    auto& settings = ApplicationSettings::getInstance();
+    auto pLimit = std::make_shared<AppIntSetting>();
+    pLimit->setName("limit");
+    pLimit->setMax(100);
+    settings.addSetting("pool", pLimit);
+
+    auto startVersion = settings.getVersion();
+    auto transaction = settings.beginTransaction();
+    transaction.setValue("pool", "size", int64_t(8));
+    transaction.setValue("pool", "timeout", 1.5);
+    transaction.setValue("pool", "limit", int64_t(50));
+    ASSERT_FALSE(settings.hasSetting("pool", "size"));
+    ASSERT_TRUE(transaction.commit());
+    ASSERT_EQ(settings.getVersion(), startVersion + 1);
+    ASSERT_EQ(settings.getSetting("pool", "size")->getValue<int64_t>(), 8);
+
+    auto pCheck = std::make_shared<ApplyRejectingSetting>();
+    pCheck->setName("zcheck");
+    settings.addSetting("pool", pCheck);
+    std::size_t poolChanges {0};
+    auto poolId = settings.getNotifier().subscribe("pool.*", [&poolChanges](const std::vector<SettingChange>& changes) {
+        poolChanges += changes.size();
+    });
+
+    // Rejected value must not leave half-applied state. "count" is staged before "limit"
+    transaction.setValue("pool", "count", int64_t(2));
+    transaction.setValue("pool", "limit", int64_t(500));
+    ASSERT_FALSE(transaction.commit());
+    ASSERT_FALSE(settings.hasSetting("pool", "count"));
+    ASSERT_EQ(pLimit->getValue<int64_t>(), 50);
+
+    // "size" is applied before "zcheck" rejects value, so it is reverted
+    transaction.setValue("pool", "size", int64_t(16));
+    transaction.setValue("pool", "zcheck", "reject");
+    ASSERT_FALSE(transaction.commit());
+    ASSERT_EQ(settings.getSetting("pool", "size")->getValue<int64_t>(), 8);
+    ASSERT_FALSE(pCheck->isSet());
+    ASSERT_EQ(settings.getVersion(), startVersion + 1);
+    ASSERT_EQ(poolChanges, 0);
+    settings.getNotifier().unsubscribe(poolId);
+    settings.removeSetting("pool", "zcheck");
+
+    transaction.setValue("pool", "size", int64_t(32));
+    transaction.removeSetting("pool", "timeout");
+    ASSERT_TRUE(transaction.commit());
+
+    auto diff = settings.diffVersions(startVersion, startVersion + 2);
+    ASSERT_EQ(diff.size(), 2); // "timeout" was added and removed
+    ASSERT_EQ(diff[1].name, "size");
+    ASSERT_FALSE(diff[1].oldValue.has_value());
+    ASSERT_EQ(std::get<int64_t>(*diff[1].newValue), 32);
+
+    ASSERT_TRUE(settings.rollbackTo(startVersion + 1));
+    ASSERT_EQ(settings.getSetting("pool", "size")->getValue<int64_t>(), 8);
+    ASSERT_EQ(settings.getSetting("pool", "timeout")->getValue<double>(), 1.5);
+    ASSERT_TRUE(settings.rollbackTo(startVersion));
+    ASSERT_FALSE(settings.hasSetting("pool", "size"));
+    ASSERT_FALSE(settings.rollbackTo(settings.getVersion() + 1));
+}
+
+TEST(AppSettings, ScopedOverrides) {
+    auto& settings = ApplicationSettings::getInstance();
+    settings.addSetting("experiment", "variant")->setValue("A");
+
+    {
+        ScopedSettingOverride outer("experiment", "variant", "B");
+        ASSERT_EQ(settings.getSetting("experiment", "variant")->getValueString(), "B");
+        {
+            ScopedSettingOverride inner("experiment", "variant", "C");
+            ASSERT_EQ(settings.getSetting("experiment", "variant")->getValueString(), "C");
+
+            std::string otherThreadValue;
+            std::thread([&]() {
+                otherThreadValue = settings.getSetting("experiment", "variant")->getValueString();
+            }).join();
+            ASSERT_EQ(otherThreadValue, "A");
+        }
+        ASSERT_EQ(settings.getSetting("experiment", "variant")->getValueString(), "B");
+    }
+    ASSERT_EQ(settings.getSetting("experiment", "variant")->getValueString(), "A");
+    ASSERT_FALSE(ScopedSettingOverride::hasActiveOverrides());
+}
+
+TEST(AppSettings, LazyConversion) {
+    AppSetting sett;
+    ASSERT_TRUE(sett.setRawValue("42"));
+    ASSERT_TRUE(sett.isSet());
+    ASSERT_EQ(*sett.getRawValue(), "42");
+    ASSERT_EQ(sett.getValue<int64_t>(), 42);
+    ASSERT_EQ(sett.getValueString(), "42");
+
+    ASSERT_TRUE(sett.setValue(1.5));
+    ASSERT_FALSE(sett.getRawValue().has_value());
+    ASSERT_EQ(sett.getValueString(), "1.500000");
+
+    ASSERT_TRUE(sett.setRawValue(""));
+    ASSERT_FALSE(sett.isSet());
+
+    AppIntSetting intSett;
+    intSett.setMax(10);
+    ASSERT_FALSE(intSett.setRawValue("11"));
+    ASSERT_TRUE(intSett.setRawValue("9"));
+    ASSERT_EQ(intSett.getValue<int64_t>(), 9);
+}
+
+TEST(AppSettings, LoadRollback) {
+    auto configPath = (std::filesystem::temp_directory_path() / ("common_test_" + std::to_string(getpid()) + ".ini")).string();
+    auto writeConfig = [&configPath](const std::string& text) {
+        std::ofstream(configPath) << text;
+    };
+
+    auto& settings = ApplicationSettings::getInstance();
+    writeConfig("[load]\nworkers=4\nname=first\n");
+    settings.loadSettings(configPath);
+    auto goodVersion = settings.getVersion();
+    ASSERT_EQ(settings.getSetting("load", "workers")->getValue<int64_t>(), 4);
+
+    writeConfig("[load]\nworkers=400\n");
+    settings.loadSettings(configPath);
+    ASSERT_FALSE(settings.hasSetting("load", "name"));
+
+    auto diff = settings.diffVersions(goodVersion, settings.getVersion());
+    ASSERT_EQ(diff.size(), 2);
+    ASSERT_EQ(std::get<int64_t>(*diff[1].oldValue), 4);
+    ASSERT_EQ(std::get<int64_t>(*diff[1].newValue), 400);
+
+    ASSERT_TRUE(settings.rollbackTo(goodVersion));
+    ASSERT_EQ(settings.getSetting("load", "workers")->getValue<int64_t>(), 4);
+    ASSERT_EQ(settings.getSetting("load", "name")->getValueString(), "first");
+    std::filesystem::remove(configPath);
+}
+
+TEST(AppSettings, ArraySettings) {
+    ASSERT_TRUE(std::holds_alternative<std::vector<int64_t> >(valueFromString("1, 2,3")));
+    ASSERT_TRUE(std::holds_alternative<std::vector<double> >(valueFromString("1,2.5")));
+    ASSERT_TRUE(std::holds_alternative<std::string>(valueFromString("a,b")));
+    ASSERT_TRUE(std::holds_alternative<std::string>(valueFromString("1,,2")));
+
+    // Typed settings, registered before load, parse and check values of config
+    auto& settings = ApplicationSettings::getInstance();
+    auto pPorts = std::make_shared<AppIntArraySetting>();
+    pPorts->setName("ports");
+    pPorts->setMax(65535);
+    settings.addSetting("arrays", pPorts);
+    auto pHosts = std::make_shared<AppStringListSetting>();
+    pHosts->setName("hosts");
+    settings.addSetting("arrays", pHosts);
+
+    auto configPath = (std::filesystem::temp_directory_path() / ("common_array_" + std::to_string(getpid()) + ".ini")).string();
+    std::ofstream(configPath) << "[arrays]\nports=80, 443,8080\nweights=0.5,1.5\nhosts=a.com,b.com\n";
+    settings.loadSettings(configPath);
+    ASSERT_EQ(settings.getSetting("arrays", "weights")->getArray<double>()[1], 1.5);
+    ASSERT_EQ(settings.getSetting("arrays", "ports"), pPorts);
+    ASSERT_EQ(settings.getSetting("arrays", "hosts"), pHosts);
+
+    auto ports = pPorts->getValues();
+    ASSERT_EQ(ports.size(), 3);
+    ASSERT_EQ(ports[2], 8080);
+    ASSERT_EQ(pHosts->getValues()[1], "b.com");
+
+    // Invalid value of config is rejected, previous value is kept
+    std::ofstream(configPath) << "[arrays]\nports=80,70000\nweights=0.5,1.5\nhosts=a.com,b.com\n";
+    settings.loadSettings(configPath);
+    ASSERT_EQ(settings.getSetting("arrays", "ports"), pPorts);
+    ASSERT_EQ(pPorts->getValues().size(), 3);
+    ASSERT_EQ(pPorts->getValues()[2], 8080);
+
+    ASSERT_FALSE(pPorts->setRawValue("80,70000"));
+    ASSERT_FALSE(pPorts->setValue(int64_t(80)));
+    ASSERT_EQ(pPorts->getValues().size(), 3);
+    pPorts->setMax(443);
+    ASSERT_EQ(pPorts->getValues()[2], 443);
+    ASSERT_EQ(settings.getSetting("arrays", "ports")->getArray<int64_t>()[2], 443);
+
+    const std::string segmentName = "/common-array-" + std::to_string(getpid());
+    SharedSettingsSegment segment;
+    ASSERT_TRUE(segment.create(segmentName));
+    ASSERT_TRUE(segment.publish(settings));
+    ASSERT_EQ(std::get<std::vector<int64_t> >(segment.getValue("arrays", "ports")), (std::vector<int64_t> {80, 443, 443}));
+    ASSERT_EQ(std::get<std::vector<std::string> >(segment.getValue("arrays", "hosts"))[0], "a.com");
+    segment.readValue("arrays", "ports", [](const SharedValueView& view) {
+        ASSERT_EQ(view.getType(), SharedValueView::IntArray);
+        ASSERT_EQ(view.getIntArray().size(), 3);
+        ASSERT_EQ(view.getIntArray()[2], 443);
+    });
+    ASSERT_EQ(segment.readValue("arrays", "hosts", [](const SharedValueView& view) {
+        return view.getStringListElement(1);
+    }), "b.com");
+
+    settings.saveSettings(configPath);
+    std::ifstream savedConfig(configPath);
+    std::string savedText((std::istreambuf_iterator<char>(savedConfig)), std::istreambuf_iterator<char>());
+    ASSERT_NE(savedText.find("80,443,443"), std::string::npos);
+    std::filesystem::remove(configPath);
+}
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+TEST(AppSettings, SettingsItemModel) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    int argc {1};
+    char appName[] = "Common_test";
+    char* argv[] = {appName, nullptr};
+    QCoreApplication app(argc, argv);
+
+    // Generated config with 100k keys
+    auto configPath = std::filesystem::temp_directory_path() / "common_test_model.ini";
+    {
+        std::ofstream config(configPath);
+        for (int i = 0; i < 100000; ++i) {
+            if (i % 1000 == 0) {
+                config << "[model_" << i / 1000 << "]\n";
+            }
+            config << "key_" << i << "=" << i << "\n";
+        }
+    }
+    auto& settings = ApplicationSettings::getInstance();
+    settings.loadSettings(configPath.string());
+
+    auto waitIdle = [&app](SettingsItemModel& model) {
+        while (model.isBusy()) {
+            app.processEvents(QEventLoop::AllEvents, 10);
+        }
+        app.processEvents();
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    SettingsItemModel model(settings);
+    auto openTime = std::chrono::steady_clock::now() - startTime;
+    ASSERT_GE(model.rowCount(), 100);
+    RecordProperty("open_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(openTime).count()));
+
+    startTime = std::chrono::steady_clock::now();
+    model.setFilter("KEY_4242");
+    waitIdle(model);
+    auto filterTime = std::chrono::steady_clock::now() - startTime;
+    RecordProperty("filter_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(filterTime).count()));
+    ASSERT_EQ(model.rowCount(), 2); // key_4242 in model_4, key_42420..42429 in model_42
+    auto sectionIndex = model.index(0, 0);
+    EXPECT_EQ(model.data(sectionIndex).toString(), "model_4");
+    ASSERT_EQ(model.rowCount(sectionIndex), 1);
+    EXPECT_EQ(model.data(model.index(0, SettingsItemModel::ValueColumn, sectionIndex)).toString(), "4242");
+
+    // Value change is reported for the row only
+    int changedCount {0};
+    int resetCount {0};
+    QObject::connect(&model, &QAbstractItemModel::dataChanged, [&changedCount]() { ++changedCount; });
+    QObject::connect(&model, &QAbstractItemModel::modelReset, [&resetCount]() { ++resetCount; });
+    settings.getSetting("model_4", "key_4242")->setValue(int64_t(1));
+    app.processEvents();
+    EXPECT_EQ(changedCount, 1);
+    EXPECT_EQ(resetCount, 0);
+    EXPECT_EQ(model.data(model.index(0, SettingsItemModel::ValueColumn, sectionIndex)).toString(), "1");
+
+    model.setFilter({});
+    waitIdle(model);
+    EXPECT_EQ(model.rowCount(), 100);
+    model.sort(SettingsItemModel::NameColumn, Qt::DescendingOrder);
+    waitIdle(model);
+    EXPECT_EQ(model.data(model.index(0, 0, model.index(0, 0))).toString(), "key_999");
+
+    std::filesystem::remove(configPath);
+}
+
+TEST(AppSettings, SettingsItemModelReload) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    int argc {1};
+    char appName[] = "Common_test";
+    char* argv[] = {appName, nullptr};
+    QCoreApplication app(argc, argv);
+
+    auto configPath = std::filesystem::temp_directory_path() / "common_test_model_reload.ini";
+    std::ofstream(configPath) << "[reload_a]\ngone=1\nkept=2\n[reload_b]\nonly=3\n";
+    auto& settings = ApplicationSettings::getInstance();
+    settings.loadSettings(configPath.string());
+
+    SettingsItemModel model(settings);
+    model.setFilter("reload_");
+    while (model.isBusy()) {
+        app.processEvents(QEventLoop::AllEvents, 10);
+    }
+    app.processEvents();
+    ASSERT_EQ(model.rowCount(), 2);
+
+    // Keys, missing in reloaded config, are removed from model, section without keys disappears
+    int removedCount {0};
+    QObject::connect(&model, &QAbstractItemModel::rowsRemoved, [&removedCount]() { ++removedCount; });
+    std::ofstream(configPath) << "[reload_a]\nadded=4\nkept=2\n";
+    settings.loadSettings(configPath.string());
+    app.processEvents();
+    EXPECT_EQ(removedCount, 2);
+    ASSERT_EQ(model.rowCount(), 1);
+    auto sectionIndex = model.index(0, 0);
+    EXPECT_EQ(model.data(sectionIndex).toString(), "reload_a");
+    ASSERT_EQ(model.rowCount(sectionIndex), 2);
+    EXPECT_EQ(model.data(model.index(0, SettingsItemModel::NameColumn, sectionIndex)).toString(), "added");
+    EXPECT_EQ(model.data(model.index(1, SettingsItemModel::ValueColumn, sectionIndex)).toString(), "2");
+
+    std::filesystem::remove(configPath);
+}
+#endif // COMPONENTS_IS_ENABLED_QT
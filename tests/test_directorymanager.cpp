@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+
+#include <Components/Ecosystem/AtomicFileWriter.h>
+#include <Components/Ecosystem/BackupEngine.h>
+#include <Components/Ecosystem/DirectoryManager.h>
+#include <Components/Ecosystem/DirectoryMonitor.h>
+#include <Components/Ecosystem/MappedFileRegistry.h>
+#include <Components/Ecosystem/PluginRegistry.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cmath>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Common;
+
+TEST(DirectoryManager, RelativeFileAccess) {
+    auto& dirManager = DirectoryManager::getInstance();
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_dirs_" + std::to_string(getpid()));
+    dirManager.setRootPath(rootPath);
+
+    auto& dataPath = dirManager.getDirectory(DirectoryType::Data);
+    ASSERT_EQ(dataPath, rootPath / "data");
+    ASSERT_EQ(&dataPath, &DirectoryManager::getDirectoryStatic(DirectoryType::Data));
+
+    auto fd = dirManager.openFile(DirectoryType::Data, "file.bin", O_WRONLY | O_CREAT | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "abc", 3), 3);
+    ::close(fd);
+
+    struct stat fileStat;
+    ASSERT_TRUE(dirManager.statFile(DirectoryType::Data, "file.bin", fileStat));
+    ASSERT_EQ(fileStat.st_size, 3);
+    ASSERT_FALSE(dirManager.statFile(DirectoryType::Data, "missing.bin", fileStat));
+    ASSERT_LT(dirManager.getDirectoryFd(DirectoryType::UserDefined + 1), 0);
+
+    // Concurrent lookups and registrations, results are checked in main thread
+    std::vector<std::thread> threads;
+    std::atomic<int> failedLookups {0};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&dirManager, &rootPath, &failedLookups, i]() {
+            for (int j = 0; j < 1000; ++j) {
+                dirManager.registerDirectory(DirectoryType::UserDefined + i, rootPath / (j % 2 ? "data" : "log"));
+                if (dirManager.getDirectoryFd(DirectoryType::Data) < 0 || dirManager.getDirectory(DirectoryType::UserDefined + i).empty()) {
+                    ++failedLookups;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(failedLookups, 0);
+    ASSERT_TRUE(dirManager.statFile(DirectoryType::UserDefined, "file.bin", fileStat));
+
+    // Descriptor of removed directory is opened again
+    std::filesystem::remove_all(rootPath / "data");
+    std::filesystem::create_directory(rootPath / "data");
+    fd = dirManager.openFile(DirectoryType::Data, "file.bin", O_WRONLY | O_CREAT | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+    ASSERT_TRUE(std::filesystem::exists(rootPath / "data" / "file.bin"));
+    ASSERT_TRUE(dirManager.statFile(DirectoryType::UserDefined, "file.bin", fileStat));
+    std::filesystem::remove_all(rootPath);
+}
+
+TEST(DirectoryManager, AtomicFileWriter) {
+    auto& dirManager = DirectoryManager::getInstance();
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_writer_" + std::to_string(getpid()));
+    dirManager.setRootPath(rootPath);
+
+    auto& writer = AtomicFileWriter::getInstance();
+    ASSERT_TRUE(writer.writeFile(DirectoryType::Data, "state.txt", "first", Durability::None));
+    ASSERT_TRUE(writer.writeFile(DirectoryType::Data, "state.txt", "second", Durability::Data));
+    auto readFile = [](const std::filesystem::path& p) {
+        std::ifstream input(p);
+        return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    };
+    ASSERT_EQ(readFile(rootPath / "data" / "state.txt"), "second");
+    ASSERT_FALSE(writer.writeFile(DirectoryType::Data, "missing/state.txt", "x"));
+
+    // Concurrent writers with full durability share directory syncs. Writers start together to overlap
+    auto syncsBefore = writer.getDirectorySyncCount();
+    std::vector<std::thread> threads;
+    std::atomic<bool> isStarted {false};
+    std::atomic<int> failedWrites {0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&writer, &isStarted, &failedWrites, i]() {
+            while (!isStarted) {
+                std::this_thread::yield();
+            }
+            for (int j = 0; j < 20; ++j) {
+                auto name = "file_" + std::to_string(i) + "_" + std::to_string(j);
+                if (!writer.writeFile(DirectoryType::Data, name, name, Durability::Full)) {
+                    ++failedWrites;
+                }
+            }
+        });
+    }
+    isStarted = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(failedWrites, 0);
+    ASSERT_LT(writer.getDirectorySyncCount() - syncsBefore, 8 * 20);
+    ASSERT_EQ(readFile(rootPath / "data" / "file_7_19"), "file_7_19");
+
+    std::size_t filesCount {0};
+    for (auto& entry : std::filesystem::directory_iterator(rootPath / "data")) {
+        ASSERT_NE(entry.path().filename().string()[0], '.'); // No temporary files left
+        ++filesCount;
+    }
+    ASSERT_EQ(filesCount, 8 * 20 + 1);
+    std::filesystem::remove_all(rootPath);
+}
+
+TEST(DirectoryManager, IncrementalBackup) {
+    auto& dirManager = DirectoryManager::getInstance();
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_backup_" + std::to_string(getpid()));
+    dirManager.setRootPath(rootPath);
+    auto writeFile = [&rootPath](const std::filesystem::path& relPath, const std::string& text) {
+        std::filesystem::create_directories((rootPath / relPath).parent_path());
+        std::ofstream(rootPath / relPath) << text;
+    };
+    auto readFile = [&rootPath](const std::filesystem::path& relPath) {
+        std::ifstream input(rootPath / relPath);
+        return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    };
+    writeFile("config/app.ini", "[main]\nvalue=1\n");
+    writeFile("data/db/main.db", std::string(100000, 'd'));
+    writeFile("data/db/copy.db", std::string(100000, 'd'));
+    std::filesystem::create_symlink(rootPath / "data/db/main.db", rootPath / "data/link.db"); // Skipped
+
+    // Files, modified just before snapshot, are hashed again by next one
+    auto oldTime = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    for (auto relPath : {"config/app.ini", "data/db/main.db", "data/db/copy.db"}) {
+        std::filesystem::last_write_time(rootPath / relPath, oldTime);
+    }
+
+    BackupEngine engine;
+    BackupOptions options;
+    options.keepGenerations = 2;
+    BackupStats stats;
+    ASSERT_TRUE(engine.createBackup(options, &stats));
+    ASSERT_EQ(stats.generation, 1);
+    ASSERT_EQ(stats.filesCount, 3);
+    ASSERT_EQ(stats.filesCopied, 2); // Same content is stored once
+
+    ASSERT_TRUE(engine.createBackup(options, &stats));
+    ASSERT_EQ(stats.filesHashed, 0);
+    ASSERT_EQ(stats.filesCopied, 0);
+
+    // Same size and mtime, change is found by ctime
+    writeFile("config/app.ini", "[main]\nvalue=2\n");
+    std::filesystem::last_write_time(rootPath / "config/app.ini", oldTime);
+    options.ioRateLimit = 10 * 1024 * 1024;
+    ASSERT_TRUE(engine.createBackup(options, &stats));
+    ASSERT_EQ(stats.filesHashed, 1);
+    ASSERT_EQ(stats.filesCopied, 1);
+    ASSERT_EQ(engine.getGenerations(), (std::vector<uint64_t> {2, 3}));
+
+    writeFile("data/db/main.db", "corrupted");
+    ASSERT_TRUE(engine.restoreBackup(2));
+    ASSERT_EQ(readFile("config/app.ini"), "[main]\nvalue=1\n");
+    ASSERT_EQ(readFile("data/db/main.db"), std::string(100000, 'd'));
+    ASSERT_TRUE(engine.restoreBackup(3, {DirectoryType::Config}));
+    ASSERT_EQ(readFile("config/app.ini"), "[main]\nvalue=2\n");
+    ASSERT_FALSE(engine.restoreBackup(1));
+
+    // Object with same hash, but other content, stands for hash collision. It is not used for new file
+    for (const auto& objectEntry : std::filesystem::directory_iterator(rootPath / "backup/objects")) {
+        if (objectEntry.file_size() == 100000) {
+            std::filesystem::remove(objectEntry.path());
+            std::ofstream(objectEntry.path()) << std::string(100000, 'x');
+        }
+    }
+    writeFile("data/collision.db", std::string(100000, 'd'));
+    ASSERT_FALSE(engine.createBackup(options, &stats));
+    ASSERT_EQ(engine.getGenerations(), (std::vector<uint64_t> {2, 3}));
+
+    // Entries of manifest must not point outside of directories
+    std::ofstream(rootPath / "backup/generations/000000000009.manifest")
+            << "COMMONBACKUP 2\t0\n1\t" << std::string(32, '0') << "\t1\t0\t0\t0\t420\tdb/../../escape.txt\n";
+    ASSERT_FALSE(engine.restoreBackup(9));
+    ASSERT_FALSE(std::filesystem::exists(rootPath / "escape.txt"));
+    std::filesystem::remove_all(rootPath);
+}
+
+TEST(DirectoryManager, PluginRegistry) {
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_plugins_" + std::to_string(getpid()));
+    DirectoryManager::getInstance().setRootPath(rootPath);
+
+    // System library stands for plugin: one copy with manifest, other named by file
+    Dl_info libraryInfo;
+    ASSERT_NE(::dladdr(reinterpret_cast<void*>(&::cos), &libraryInfo), 0);
+    auto pluginsPath = rootPath / "plugins";
+    std::filesystem::copy_file(libraryInfo.dli_fname, pluginsPath / "libmath.so");
+    std::ofstream(pluginsPath / "libmath.so.plugin") << "name=math\nversion=2.1\n";
+    std::filesystem::copy_file(libraryInfo.dli_fname, pluginsPath / "libunused.so.6");
+    std::ofstream(pluginsPath / "readme.txt") << "not a plugin";
+
+    PluginRegistry registry;
+    ASSERT_TRUE(registry.scan(2));
+    ASSERT_EQ(registry.getPluginNames(), (std::vector<std::string> {"math", "unused"}));
+    ASSERT_EQ(registry.getPluginInfo("math")->metadata.at("version"), "2.1");
+    ASSERT_FALSE(registry.isLoaded("math"));
+
+    auto pCos = registry.getFunction<double(double)>("math", "cos");
+    ASSERT_NE(pCos, nullptr);
+    ASSERT_EQ(pCos(0.0), 1.0);
+    ASSERT_TRUE(registry.isLoaded("math"));
+    ASSERT_FALSE(registry.isLoaded("unused"));
+    ASSERT_EQ(registry.getSymbol("missing", "cos"), nullptr);
+
+    registry.prewarm();
+    registry.waitPrewarm();
+    ASSERT_TRUE(registry.isLoaded("unused"));
+    std::filesystem::remove_all(rootPath);
+}
+
+TEST(DirectoryManager, DirectoryMonitor) {
+    auto& dirManager = DirectoryManager::getInstance();
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_monitor_" + std::to_string(getpid()));
+    dirManager.setRootPath(rootPath);
+    for (int i = 0; i < 100; ++i) {
+        dirManager.registerDirectory(DirectoryType::UserDefined + i, rootPath / "user" / std::to_string(i));
+    }
+    std::ofstream(rootPath / "blocked") << "file in place of parent directory";
+    dirManager.registerDirectory(DirectoryType::UserDefined + 200, rootPath / "blocked" / "dir");
+
+    std::mutex eventsMx;
+    std::condition_variable eventsCv;
+    std::vector<DirectoryEvent> events;
+    auto waitEvent = [&](DirectoryEvent::Type type, int dtype) {
+        std::unique_lock lock(eventsMx);
+        return eventsCv.wait_for(lock, std::chrono::seconds(5), [&]() {
+            return std::any_of(events.begin(), events.end(), [&](const DirectoryEvent& event) {
+                return (event.type == type && event.dtype == dtype);
+            });
+        });
+    };
+
+    DirectoryMonitor monitor;
+    monitor.subscribe([&](const DirectoryEvent& event) {
+        std::lock_guard lock(eventsMx);
+        events.push_back(event);
+        eventsCv.notify_all();
+    });
+    DirectoryMonitorOptions options;
+    options.pollInterval = std::chrono::milliseconds(20);
+    options.lowSpaceThreshold = UINT64_MAX;
+    ASSERT_TRUE(monitor.start(options));
+
+    // User-defined directories were not created by init, monitor creates them
+    ASSERT_TRUE(waitEvent(DirectoryEvent::Recreated, DirectoryType::UserDefined + 99));
+    ASSERT_TRUE(std::filesystem::is_directory(rootPath / "user" / "99"));
+    ASSERT_TRUE(waitEvent(DirectoryEvent::LowSpace, DirectoryType::Config));
+
+    ASSERT_GE(dirManager.getDirectoryFd(DirectoryType::Logs), 0);
+    std::filesystem::remove_all(rootPath / "log");
+    ASSERT_TRUE(waitEvent(DirectoryEvent::Missing, DirectoryType::Logs));
+    ASSERT_TRUE(waitEvent(DirectoryEvent::Recreated, DirectoryType::Logs));
+    auto fd = dirManager.openFile(DirectoryType::Logs, "app.log", O_WRONLY | O_CREAT);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+    ASSERT_TRUE(std::filesystem::exists(rootPath / "log" / "app.log"));
+
+    // Directory, which could not be created, is checked again on each poll
+    ASSERT_TRUE(waitEvent(DirectoryEvent::Missing, DirectoryType::UserDefined + 200));
+    std::filesystem::remove(rootPath / "blocked");
+    ASSERT_TRUE(waitEvent(DirectoryEvent::Recreated, DirectoryType::UserDefined + 200));
+    {
+        std::lock_guard lock(eventsMx);
+        ASSERT_EQ(std::count_if(events.begin(), events.end(), [](const DirectoryEvent& event) {
+            return (event.type == DirectoryEvent::Missing && event.dtype == DirectoryType::UserDefined + 200);
+        }), 1);
+    }
+
+    monitor.stop();
+    std::filesystem::remove_all(rootPath);
+}
+
+TEST(DirectoryManager, MappedFileRegistry) {
+    auto& dirManager = DirectoryManager::getInstance();
+    auto rootPath = std::filesystem::temp_directory_path() / ("common_mapped_" + std::to_string(getpid()));
+    dirManager.setRootPath(rootPath);
+    auto toString = [](const MappedFilePtr& pMapping) {
+        auto data = pMapping->getData();
+        return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+    };
+
+    auto& writer = AtomicFileWriter::getInstance();
+    ASSERT_TRUE(writer.writeFile(DirectoryType::Data, "table.bin", "first version"));
+    MappedFileRegistry registry;
+    ASSERT_EQ(registry.map(DirectoryType::Data, "missing.bin"), nullptr);
+    auto pFirst = registry.map(DirectoryType::Data, "table.bin", {MappingAccess::Random, MappingPrefetch::Synchronous});
+    ASSERT_NE(pFirst, nullptr);
+    ASSERT_EQ(toString(pFirst), "first version");
+    ASSERT_EQ(registry.map(DirectoryType::Data, "./table.bin"), pFirst);
+    ASSERT_EQ(registry.getMappingsCount(), 1);
+
+    // Replaced file is mapped again, holders of old mapping still see old contents
+    ASSERT_TRUE(writer.writeFile(DirectoryType::Data, "table.bin", "second version, longer"));
+    auto pSecond = registry.map(DirectoryType::Data, "table.bin", {MappingAccess::Sequential, MappingPrefetch::Background});
+    ASSERT_NE(pSecond, pFirst);
+    ASSERT_EQ(toString(pSecond), "second version, longer");
+    ASSERT_EQ(toString(pFirst), "first version");
+    registry.waitPrefetch();
+
+    ASSERT_TRUE(writer.writeFile(DirectoryType::Data, "empty.bin", ""));
+    auto pEmpty = registry.map(DirectoryType::Data, "empty.bin");
+    ASSERT_NE(pEmpty, nullptr);
+    ASSERT_TRUE(pEmpty->getData().empty());
+
+    pFirst.reset();
+    ASSERT_EQ(registry.getMappingsCount(), 2);
+    pSecond.reset();
+    pEmpty.reset();
+    ASSERT_EQ(registry.getMappingsCount(), 0);
+    std::filesystem::remove_all(rootPath);
+}
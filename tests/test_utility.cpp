@@ -0,0 +1,398 @@
+#include <gtest/gtest.h>
+
+#include <Components/Ecosystem/DirectoryManager.h>
+#include <Components/Ecosystem/Executor.h>
+#include <Components/Ecosystem/ShutdownCoordinator.h>
+#include <Components/Ecosystem/Symbolizer.h>
+#include <Components/Ecosystem/TerminalScreen.h>
+#include <Components/Ecosystem/Tracing.h>
+#include <Components/Ecosystem/Utility.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace Common;
+
+namespace {
+
+__attribute__((noinline)) CapturedStacktrace captureInProbe() {
+    auto res = CapturedStacktrace::capture();
+    asm volatile("" ::: "memory"); // Prevent tail call
+    return res;
+}
+
+int64_t parallelSum(Executor& executor, int64_t from, int64_t to) {
+    if (to - from <= 16) {
+        int64_t res {0};
+        for (auto i = from; i < to; ++i) {
+            res += i;
+        }
+        return res;
+    }
+    auto middle = from + (to - from) / 2;
+    auto left = executor.submit([&executor, from, middle]() { return parallelSum(executor, from, middle); });
+    auto right = parallelSum(executor, middle, to);
+    return left.get() + right;
+}
+
+std::string readAvailable(int fd) {
+    std::string res;
+    char buffer[4096];
+    pollfd pollFd {fd, POLLIN, 0};
+    while (::poll(&pollFd, 1, 50) > 0) {
+        auto readBytes = ::read(fd, buffer, sizeof(buffer));
+        if (readBytes <= 0) {
+            break;
+        }
+        res.append(buffer, readBytes);
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(Utility, TerminalScreenDiff) {
+    int masterFd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(masterFd, 0);
+    ASSERT_EQ(::grantpt(masterFd), 0);
+    ASSERT_EQ(::unlockpt(masterFd), 0);
+    int slaveFd = ::open(::ptsname(masterFd), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slaveFd, 0);
+    termios rawMode;
+    ::tcgetattr(slaveFd, &rawMode);
+    ::cfmakeraw(&rawMode);
+    ::tcsetattr(slaveFd, TCSANOW, &rawMode);
+
+    TerminalScreen screen(80, 24, slaveFd);
+    for (unsigned y = 0; y < 20; ++y) {
+        screen.putText(0, y, "worker " + std::to_string(y) + ": idle");
+    }
+    screen.putText(0, 22, "статус", TerminalColor::Green, TerminalColor::Default, true);
+    ASSERT_TRUE(screen.present());
+    auto firstFrame = readAvailable(masterFd);
+    ASSERT_EQ(firstFrame.size(), screen.getLastFrameSize());
+    ASSERT_NE(firstFrame.find("worker 19: idle"), std::string::npos);
+    ASSERT_NE(firstFrame.find("\x1b[0;1;32mстатус"), std::string::npos);
+
+    // Unchanged frame writes nothing
+    ASSERT_TRUE(screen.present());
+    ASSERT_EQ(screen.getLastFrameSize(), 0);
+
+    // One changed word: cursor move and changed cells only
+    screen.putText(10, 7, "busy");
+    ASSERT_TRUE(screen.present());
+    auto frame = readAvailable(masterFd);
+    ASSERT_EQ(frame, "\x1b[8;11H\x1b[0mbusy"); // Attributes of previous frame are reset
+    ASSERT_EQ(screen.getCursorPosition(), std::make_pair(14u, 7u));
+
+    // Close changes are joined, next row is reached with "\r\n"
+    screen.putText(10, 8, "b");
+    screen.putText(13, 8, "y");
+    screen.putText(0, 9, "W");
+    ASSERT_TRUE(screen.present());
+    ASSERT_EQ(readAvailable(masterFd), "\x1b[9;11Hbdly\r\nW");
+
+    // Control characters must not reach terminal, escape sequence is shown as text
+    ASSERT_EQ(screen.putText(0, 10, "a\x1b[2Jb\r\x7f"), 8u);
+    ASSERT_EQ(screen.getCell(1, 10).ch, U'\uFFFD');
+    ASSERT_EQ(screen.getCell(2, 10).ch, U'[');
+    ASSERT_TRUE(screen.present());
+    ASSERT_EQ(readAvailable(masterFd), "\r\na\uFFFD[2Jb\uFFFD\uFFFD");
+
+    ::close(slaveFd);
+    ::close(masterFd);
+}
+
+TEST(Utility, Executor) {
+    Executor executor({4, {}});
+    ASSERT_EQ(executor.getThreadsCount(), 4u);
+    EXPECT_EQ(executor.submit([]() { return 42; }).get(), 42);
+
+    auto chained = executor.submit([]() { return 20; })
+                       .then([](int v) { return std::to_string(v + 1); })
+                       .then([](const std::string& s) { return s + "!"; });
+    EXPECT_EQ(chained.get(), "21!");
+
+    auto failed = executor.submit([]() -> int { throw std::runtime_error("task failed"); })
+                      .then([](int v) { return v * 2; });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    // Nested waits in workers must not exhaust pool
+    EXPECT_EQ(executor.submit([&executor]() { return parallelSum(executor, 0, 100000); }).get(),
+              int64_t(100000) * 99999 / 2);
+
+    std::atomic<int> counter {0};
+    std::vector<Future<void> > futures;
+    for (int i = 0; i < 10000; ++i) {
+        futures.push_back(executor.submit([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    EXPECT_EQ(counter.load(), 10000);
+}
+
+TEST(Utility, UniqueIdUniqueness) {
+    constexpr std::size_t threadsCount {8};
+    constexpr std::size_t idsPerThread {200000};
+    std::vector<std::vector<UniqueId> > threadIds(threadsCount, std::vector<UniqueId>(idsPerThread));
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&ids = threadIds[t], t]() {
+            if (t % 2 == 0) {
+                generateUniqueIds(ids.data(), ids.size());
+            } else {
+                for (auto& id : ids) {
+                    id = generateUniqueId();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    struct IdHash {
+        std::size_t operator()(const UniqueId& id) const {
+            return std::hash<uint64_t>()(id.high ^ (id.low * 0x9E3779B97F4A7C15ull));
+        }
+    };
+    std::unordered_set<UniqueId, IdHash> allIds;
+    for (auto& ids : threadIds) {
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            if (i != 0) {
+                ASSERT_TRUE(ids[i - 1] < ids[i]);
+            }
+            ASSERT_TRUE(allIds.insert(ids[i]).second);
+        }
+    }
+
+    auto id = generateUniqueId();
+    auto text = id.toString();
+    ASSERT_EQ(text.size(), UniqueId::BASE32_LENGTH);
+    EXPECT_EQ(UniqueId::fromBase32(text), id);
+    EXPECT_FALSE(UniqueId::fromBase32("8ZZZZZZZZZZZZZZZZZZZZZZZZZ").has_value());
+    EXPECT_NEAR(double(id.getTimestampMs()), double(getEpoch() * 1000), 2000.0);
+
+    char hex[UniqueId::HEX_LENGTH];
+    UniqueId sample {0x0123456789abcdefull, 0xfedcba9876543210ull};
+    EXPECT_EQ(std::string(hex, sample.toHex(hex)), "0123456789abcdeffedcba9876543210");
+}
+
+TEST(Utility, RandomStreamReproducible) {
+    // Known answer of Philox4x32-10 for zero key and counter
+    RandomStream zeroStream;
+    EXPECT_EQ(zeroStream(), 0xe169c58d6627e8d5ull);
+    EXPECT_EQ(zeroStream(), 0x9b00dbd8bc57ac4cull);
+
+    // Same values for any split of array between threads
+    constexpr std::size_t valuesCount {100003};
+    constexpr std::size_t chunkSize {997};
+    RandomStream root(42);
+    std::vector<double> expectedNormal(valuesCount);
+    std::vector<int32_t> expectedInts(valuesCount);
+    root.fillNormal(expectedNormal.data(), valuesCount, 1.0, 2.0);
+    root.split(1).fillUniformInt(expectedInts.data(), valuesCount, -5, 5);
+    for (unsigned workersCount : {1u, 3u, 8u}) {
+        std::vector<double> normal(valuesCount);
+        std::vector<int32_t> ints(valuesCount);
+        auto chunksCount = (valuesCount + chunkSize - 1) / chunkSize;
+        ASSERT_TRUE(forEachParallel(chunksCount, workersCount, [&](std::size_t chunk) {
+            auto first = chunk * chunkSize;
+            auto count = std::min(chunkSize, valuesCount - first);
+            RandomStream normalStream(42);
+            normalStream.seek(first);
+            normalStream.fillNormal(normal.data() + first, count, 1.0, 2.0);
+            auto intStream = root.split(1);
+            intStream.seek(first);
+            intStream.fillUniformInt(ints.data() + first, count, -5, 5);
+            return true;
+        }));
+        ASSERT_EQ(normal, expectedNormal);
+        ASSERT_EQ(ints, expectedInts);
+    }
+
+    double sum {0.0};
+    double sumSquares {0.0};
+    for (auto value : expectedNormal) {
+        sum += value;
+        sumSquares += value * value;
+    }
+    auto mean = sum / valuesCount;
+    EXPECT_NEAR(mean, 1.0, 0.05);
+    EXPECT_NEAR(std::sqrt(sumSquares / valuesCount - mean * mean), 2.0, 0.05);
+    EXPECT_EQ(*std::min_element(expectedInts.begin(), expectedInts.end()), -5);
+    EXPECT_EQ(*std::max_element(expectedInts.begin(), expectedInts.end()), 5);
+
+    std::vector<double> reals(1000);
+    RandomStream(7).fillUniformReal(reals.data(), reals.size(), 10.0, 20.0);
+    EXPECT_TRUE(std::all_of(reals.begin(), reals.end(), [](double value) { return value >= 10.0 && value < 20.0; }));
+    EXPECT_NE(root.split(2)(), root.split(1)());
+
+    // Empty range is rejected, single value range is not
+    RandomStream rangeStream(7);
+    int32_t value {0};
+    EXPECT_THROW(rangeStream.fillUniformInt(&value, 1, 5, 4), std::invalid_argument);
+    EXPECT_EQ(rangeStream.getPosition(), 0u);
+    rangeStream.fillUniformInt(&value, 1, 5, 5);
+    EXPECT_EQ(value, 5);
+}
+
+TEST(Utility, SymbolizerCache) {
+    Symbolizer symbolizer;
+    std::vector<CapturedStacktrace> stacktraces;
+    for (int i = 0; i < 3; ++i) {
+        stacktraces.push_back(captureInProbe());
+    }
+    ASSERT_FALSE(stacktraces[0].frames.empty());
+
+    auto frames = symbolizer.symbolize(stacktraces[0]);
+    ASSERT_EQ(frames.size(), stacktraces[0].frames.size());
+    EXPECT_NE(frames[0].find("captureInProbe"), std::string::npos) << frames[0];
+    auto cacheSize = symbolizer.getCacheSize();
+    EXPECT_GT(cacheSize, 0u);
+
+    // Same call site is formatted from cache
+    EXPECT_EQ(symbolizer.symbolize(stacktraces[1]), frames);
+    EXPECT_EQ(symbolizer.getCacheSize(), cacheSize);
+    EXPECT_EQ(symbolizer.symbolizeNoWait(stacktraces[1]), frames);
+
+    std::vector<std::string> asyncFrames;
+    symbolizer.symbolizeAsync(std::move(stacktraces[2]), [&asyncFrames](const std::vector<std::string>& res) {
+        asyncFrames = res;
+    });
+    symbolizer.waitIdle();
+    EXPECT_EQ(asyncFrames, frames);
+}
+
+TEST(Utility, TracingChromeExport) {
+    auto& tracer = Tracer::getInstance();
+    tracer.clear(); // Spans of previous runs
+    auto countEvents = [&tracer](std::string_view name) {
+        auto events = tracer.getEvents();
+        return std::count_if(events.begin(), events.end(), [name](const TraceEvent& event) {
+            return (event.name == name);
+        });
+    };
+
+    tracer.setEnabled(false);
+    {
+        COMMON_TRACE_SCOPE("test_disabled_span");
+    }
+    EXPECT_EQ(countEvents("test_disabled_span"), 0);
+
+    tracer.setEnabled(true);
+    std::thread worker([]() {
+        for (int i = 0; i < 3000; ++i) { // Crosses chunk boundary
+            COMMON_TRACE_SCOPE("test_worker_span");
+        }
+    });
+    {
+        COMMON_TRACE_SCOPE("test_\"quoted\"_span");
+        DirectoryManager::getInstance().init();
+    }
+    worker.join();
+    tracer.setEnabled(false);
+
+    EXPECT_EQ(countEvents("test_worker_span"), 3000);
+    EXPECT_EQ(countEvents("DirectoryManager::init"), 1);
+
+    auto tracePath = std::filesystem::temp_directory_path() / "common_test_trace.json";
+    ASSERT_TRUE(tracer.exportChromeTrace(tracePath));
+    std::ifstream traceFile(tracePath);
+    std::string trace((std::istreambuf_iterator<char>(traceFile)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"DirectoryManager::init\",\"cat\":\"common\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("test_\\\"quoted\\\"_span"), std::string::npos);
+    std::filesystem::remove(tracePath);
+
+    // Full buffer drops spans. clear() frees buffer of exited worker, current thread replaces its buffer
+    tracer.clear();
+    EXPECT_EQ(countEvents("test_worker_span"), 0);
+    auto capacity = tracer.getThreadCapacity();
+    tracer.setThreadCapacity(10);
+    tracer.setEnabled(true);
+    for (int i = 0; i < 15; ++i) {
+        COMMON_TRACE_SCOPE("test_bounded_span");
+    }
+    tracer.setEnabled(false);
+    tracer.setThreadCapacity(capacity);
+    EXPECT_EQ(countEvents("test_bounded_span"), 10);
+    EXPECT_EQ(tracer.getDroppedCount(), 5u);
+}
+
+TEST(Utility, ShutdownCoordinator) {
+    using namespace std::chrono_literals;
+    {
+        ShutdownCoordinator coordinator;
+        std::atomic<int> startedCount {0};
+        std::atomic<int> stoppedCount {0};
+        std::chrono::steady_clock::time_point startTimes[2];
+        std::chrono::steady_clock::time_point finishTimes[2];
+        auto makeSlowHook = [&](int index) {
+            return [&, index]() {
+                startTimes[index] = std::chrono::steady_clock::now();
+                startedCount.fetch_add(1);
+                // Other hook starts meanwhile, if hooks run in parallel
+                for (auto waitStart = std::chrono::steady_clock::now();
+                     startedCount.load() < 2 && std::chrono::steady_clock::now() - waitStart < 1s; ) {
+                    std::this_thread::sleep_for(1ms);
+                }
+                std::this_thread::sleep_for(100ms);
+                finishTimes[index] = std::chrono::steady_clock::now();
+                stoppedCount.fetch_add(1);
+            };
+        };
+        ASSERT_TRUE(coordinator.addHook("server", makeSlowHook(0)));
+        ASSERT_TRUE(coordinator.addHook("cache", makeSlowHook(1)));
+        ASSERT_TRUE(coordinator.addHook("storage", [&stoppedCount]() {
+            EXPECT_EQ(stoppedCount.load(), 2); // Both dependencies are stopped
+            throw std::runtime_error("flush failed");
+        }, {"server", "cache"}));
+        EXPECT_FALSE(coordinator.addHook("server", []() {}));
+        EXPECT_FALSE(coordinator.addHook("database", []() {}, {"unknown"}));
+
+        EXPECT_TRUE(coordinator.shutdown({1000ms, false}));
+        // Independent hooks run in parallel: both are started before any of them finishes
+        EXPECT_LT(std::max(startTimes[0], startTimes[1]), std::min(finishTimes[0], finishTimes[1]));
+
+        auto reports = coordinator.getReports();
+        ASSERT_EQ(reports.size(), 3u);
+        EXPECT_GE(reports[0].duration, 100ms);
+        EXPECT_TRUE(reports[2].isCompleted);
+        EXPECT_TRUE(reports[2].isFailed);
+        EXPECT_FALSE(coordinator.addHook("late", []() {}));
+    }
+    {
+        ShutdownCoordinator coordinator;
+        coordinator.addHook("hung", []() { std::this_thread::sleep_for(500ms); });
+        auto startTime = std::chrono::steady_clock::now();
+        EXPECT_FALSE(coordinator.shutdown({50ms, false}));
+        EXPECT_LT(std::chrono::steady_clock::now() - startTime, 400ms);
+        EXPECT_FALSE(coordinator.getReports()[0].isCompleted);
+    }
+    {
+        ShutdownCoordinator coordinator;
+        std::atomic<bool> isStopped {false};
+        coordinator.addHook("server", [&isStopped]() { isStopped = true; });
+        coordinator.setupSignalHandling({1000ms, false});
+        ::raise(SIGTERM);
+        EXPECT_TRUE(coordinator.waitShutdown());
+        EXPECT_TRUE(isStopped);
+    }
+    ::signal(SIGTERM, SIG_DFL);
+}